@@ -4,32 +4,45 @@
 using namespace jmk;
 
 template<class T, size_t dim>
-static float getAngle(jmk::Vector<T, dim> v1, jmk::Vector<T,dim>v2)
+static real_t<T> getAngle(jmk::Vector<T, dim> v1, jmk::Vector<T,dim>v2)
 {
 	auto dot = dotProduct(v1, v2);
 	auto theta = acos(fabs(dot));   // debe estar llegando normalizado los vectores por eso no se necesita la magnitud. si es asi
 	return RadiansToDegrees(theta);
 }
 
-float jmk::AngleLines2D( const Line2d& l1, const Line2d l2)
+template<class coord_type>
+real_t<coord_type> jmk::AngleLines2D(const Line2dT<coord_type>& l1, const Line2dT<coord_type> l2)
 {
 	return getAngle(l1.direction(), l2.direction());
 }
 
-float jmk::AngleLines3D(const Line& l1, const Line& l2)
+template<class coord_type>
+real_t<coord_type> jmk::AngleLines3D(const LineT<coord_type>& l1, const LineT<coord_type>& l2)
 {
 	return getAngle(l1.direction(), l2.direction());
 }
 
 
-float jmk::AngleLinePlane(const Line& l, const Planef p)
+template<class coord_type>
+real_t<coord_type> jmk::AngleLinePlane(const LineT<coord_type>& l, const Plane<coord_type> p)
 {
 	auto theta = getAngle(l.direction(), p.getNormal());
 	return 90 - theta;
 }
 
 
-float jmk::AnglePlanes(const Planef p1, const Planef p2)
+template<class coord_type>
+real_t<coord_type> jmk::AnglePlanes(const Plane<coord_type> p1, const Plane<coord_type> p2)
 {
 	return getAngle(p1.getNormal(), p2.getNormal());
 }
+
+template float jmk::AngleLines2D<float>(const Line2d&, const Line2d);
+template double jmk::AngleLines2D<double>(const Line2lf&, const Line2lf);
+template float jmk::AngleLines3D<float>(const Line&, const Line&);
+template double jmk::AngleLines3D<double>(const Line3lf&, const Line3lf&);
+template float jmk::AngleLinePlane<float>(const Line&, const Planef);
+template double jmk::AngleLinePlane<double>(const Line3lf&, const Planelf);
+template float jmk::AnglePlanes<float>(const Planef, const Planef);
+template double jmk::AnglePlanes<double>(const Planelf, const Planelf);
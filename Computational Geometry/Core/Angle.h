@@ -5,12 +5,17 @@
 
 namespace jmk
 {
-	float AngleLines2D(const Line2d& l1, const Line2d l2);
+	// Instantiated for float and double coordinates
+	template<class coord_type>
+	real_t<coord_type> AngleLines2D(const Line2dT<coord_type>& l1, const Line2dT<coord_type> l2);
 
-	float AngleLines3D(const Line& l1, const Line& l2);
+	template<class coord_type>
+	real_t<coord_type> AngleLines3D(const LineT<coord_type>& l1, const LineT<coord_type>& l2);
 
-	float AngleLinePlane(const Line& l, const Planef p);
+	template<class coord_type>
+	real_t<coord_type> AngleLinePlane(const LineT<coord_type>& l, const Plane<coord_type> p);
 
-	float AnglePlanes(const Planef p1, const Planef p2);
+	template<class coord_type>
+	real_t<coord_type> AnglePlanes(const Plane<coord_type> p1, const Plane<coord_type> p2);
 }
 
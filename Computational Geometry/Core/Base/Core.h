@@ -3,6 +3,7 @@
 #define _USE_MATH_DEFINES
 
 #include<math.h>
+#include<type_traits>
 
 namespace jmk {
 #define TOLERANCE 0.0000000001
@@ -24,8 +25,13 @@ namespace jmk {
 		return x ^ y;
 	}
 
-	static float RadiansToDegrees(float radians)
+	static double RadiansToDegrees(double radians)
 	{
 		return radians * 360 / (2 * M_PI);
 	}
+
+	// Floating point type used for derived, non exact quantities (ratios, interpolated coordinates).
+	// Floating point coordinates keep their own precision, integer coordinates use double.
+	template<class coordinate_type>
+	using real_t = typename std::conditional<std::is_floating_point<coordinate_type>::value, coordinate_type, double>::type;
 }
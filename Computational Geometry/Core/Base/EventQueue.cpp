@@ -0,0 +1,91 @@
+#include "EventQueue.h"
+#include "Parallel.h"
+
+#include <algorithm>
+
+using namespace jmk;
+
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+void jmk::radix_sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& ids, unsigned thread_count)
+{
+	const size_t count = keys.size();
+	if (count < 2)
+		return;
+
+	if (count < EVENT_QUEUE_RADIX_MIN)
+	{
+		// Ties are broken on the position, which gives the same order as the stable radix passes
+		std::vector<std::pair<uint64_t, uint32_t>> pairs(count);
+		for (size_t i = 0; i < count; i++)
+			pairs[i] = { keys[i], (uint32_t)i };
+		std::sort(pairs.begin(), pairs.end());
+
+		std::vector<uint32_t> sorted_ids(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			keys[i] = pairs[i].first;
+			sorted_ids[i] = ids[pairs[i].second];
+		}
+		ids.swap(sorted_ids);
+		return;
+	}
+
+	// Bits that are not the same in every key, bytes without any are already sorted
+	uint64_t all_and = ~UINT64_C(0), all_or = 0;
+	for (uint64_t key : keys)
+	{
+		all_and &= key;
+		all_or |= key;
+	}
+	const uint64_t varying = all_and ^ all_or;
+
+	// Each chunk of the input counts its own digits, the offsets are then laid out bucket by bucket
+	// and chunk by chunk, which keeps the sort stable
+	if (thread_count == 0)
+		thread_count = default_thread_count();
+	const size_t chunks = count >= EVENT_QUEUE_PARALLEL_THRESHOLD ? std::max(1u, thread_count) : 1;
+	const size_t chunk_size = (count + chunks - 1) / chunks;
+	std::vector<size_t> offsets(chunks * RADIX_BUCKETS);
+
+	std::vector<uint64_t> keys_out(count);
+	std::vector<uint32_t> ids_out(count);
+
+	for (unsigned shift = 0; shift < 64; shift += RADIX_BITS)
+	{
+		if (((varying >> shift) & (RADIX_BUCKETS - 1)) == 0)
+			continue;
+
+		parallel_for(chunks, [&](size_t c) {
+			size_t* histogram = &offsets[c * RADIX_BUCKETS];
+			std::fill(histogram, histogram + RADIX_BUCKETS, 0);
+			const size_t end = std::min(count, (c + 1) * chunk_size);
+			for (size_t i = c * chunk_size; i < end; i++)
+				histogram[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+		}, (unsigned)chunks);
+
+		size_t sum = 0;
+		for (size_t b = 0; b < RADIX_BUCKETS; b++)
+			for (size_t c = 0; c < chunks; c++)
+			{
+				size_t bucket_count = offsets[c * RADIX_BUCKETS + b];
+				offsets[c * RADIX_BUCKETS + b] = sum;
+				sum += bucket_count;
+			}
+
+		parallel_for(chunks, [&](size_t c) {
+			size_t* next = &offsets[c * RADIX_BUCKETS];
+			const size_t end = std::min(count, (c + 1) * chunk_size);
+			for (size_t i = c * chunk_size; i < end; i++)
+			{
+				size_t to = next[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+				keys_out[to] = keys[i];
+				ids_out[to] = ids[i];
+			}
+		}, (unsigned)chunks);
+
+		keys.swap(keys_out);
+		ids.swap(ids_out);
+	}
+}
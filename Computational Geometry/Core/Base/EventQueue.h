@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+
+#include "Vector.h"
+
+// Event queue for the sweep algorithms: the order in which a top to bottom sweep meets a set of
+// points, highest y first and lowest x first on equal y (same order as Vertex2DSortTBLR).
+// The coordinates are mapped to integers with the same ordering and sorted with an LSD radix sort,
+// so building the queue is linear in the number of points instead of O(n log n) comparisons.
+
+namespace jmk {
+
+	// Inputs of at least this many points sort their digits on several threads
+#define EVENT_QUEUE_PARALLEL_THRESHOLD (1 << 16)
+
+	// Below this many points clearing the radix buckets costs more than it saves, the keys are
+	// compared instead
+#define EVENT_QUEUE_RADIX_MIN 2048
+
+	// Unsigned integers that order like the given values. For floating point values the sign bit is
+	// flipped for positives and every bit for negatives. -0 is mapped like +0, as they compare equal.
+	inline uint32_t ordered_bits(float _value)
+	{
+		_value += 0.0f;
+		uint32_t bits;
+		std::memcpy(&bits, &_value, sizeof(bits));
+		return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+	}
+
+	inline uint64_t ordered_bits(double _value)
+	{
+		_value += 0.0;
+		uint64_t bits;
+		std::memcpy(&bits, &_value, sizeof(bits));
+		return (bits & UINT64_C(0x8000000000000000)) ? ~bits : bits | UINT64_C(0x8000000000000000);
+	}
+
+	inline uint32_t ordered_bits(int32_t _value)
+	{
+		return (uint32_t)_value ^ 0x80000000u;
+	}
+
+	// Stable LSD radix sort of the (key, id) pairs by key, 11 bits per pass. Passes over digits that
+	// are the same in every key are skipped, and small inputs are sorted by comparing the keys. From
+	// EVENT_QUEUE_PARALLEL_THRESHOLD keys on, each pass counts and scatters on up to thread_count
+	// threads (0 uses every hardware thread). The result is the same whatever the thread count.
+	void radix_sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& ids, unsigned thread_count = 0);
+
+	// Fills order with the indices 0 .. count - 1 in sweep order. point_at(i) returns the i'th point.
+	template<class type, class PointAt>
+	void build_event_queue(size_t count, PointAt point_at, std::vector<uint32_t>& order, unsigned thread_count = 0)
+	{
+		order.resize(count);
+		std::iota(order.begin(), order.end(), 0u);
+
+		std::vector<uint64_t> keys(count);
+		if constexpr (sizeof(type) == sizeof(uint64_t))
+		{
+			if (count < EVENT_QUEUE_RADIX_MIN)
+			{
+				// One comparison sort on both keys, ties broken on the index like the radix passes
+				struct Event { uint64_t y, x; uint32_t id; };
+				std::vector<Event> events(count);
+				for (size_t i = 0; i < count; i++)
+					events[i] = { ~ordered_bits(point_at(i)[Y]), ordered_bits(point_at(i)[X]), (uint32_t)i };
+				std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+					return a.y != b.y ? a.y < b.y : a.x != b.x ? a.x < b.x : a.id < b.id;
+				});
+				for (size_t i = 0; i < count; i++)
+					order[i] = events[i].id;
+				return;
+			}
+
+			// 128 bit keys are sorted in two rounds, first on x then (stable) on y
+			for (size_t i = 0; i < count; i++)
+				keys[i] = ordered_bits(point_at(i)[X]);
+			radix_sort(keys, order, thread_count);
+
+			for (size_t i = 0; i < count; i++)
+				keys[i] = ~ordered_bits(point_at(order[i])[Y]);
+			radix_sort(keys, order, thread_count);
+		}
+		else
+		{
+			// y descending in the high half, x ascending in the low half
+			for (size_t i = 0; i < count; i++)
+			{
+				const auto& point = point_at(i);
+				keys[i] = ((uint64_t)~ordered_bits(point[Y]) << 32) | ordered_bits(point[X]);
+			}
+			radix_sort(keys, order, thread_count);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace jmk {
+
+	// Number of threads to use when 0 is given
+	inline unsigned default_thread_count()
+	{
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Calls f(i) for every i in [0, count) on up to thread_count threads, the calling thread included.
+	// Items are handed out one at a time through a shared counter, so uneven items still balance out.
+	// Returns once all the items are done.
+	template<class Function>
+	void parallel_for(size_t count, Function f, unsigned thread_count = 0)
+	{
+		if (thread_count == 0)
+			thread_count = default_thread_count();
+		thread_count = (unsigned)std::min<size_t>(thread_count, count);
+
+		std::atomic<size_t> next_item(0);
+		auto worker = [&]() {
+			for (size_t i = next_item++; i < count; i = next_item++)
+				f(i);
+		};
+
+		if (thread_count <= 1)
+		{
+			worker();
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		for (unsigned t = 1; t < thread_count; t++)
+			threads.emplace_back(worker);
+		worker();
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+}
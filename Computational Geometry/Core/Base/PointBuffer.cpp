@@ -0,0 +1,266 @@
+#include "PointBuffer.h"
+#include "Simd.h"
+
+#include <cassert>
+
+using namespace jmk;
+
+// Each kernel processes full SIMD lanes first and finishes the remaining points with a scalar loop.
+// The coordinate arrays are aligned, the output vectors are not, so stores are unaligned.
+
+#if defined(JMK_SIMD_AVX2)
+#define SIMD_WIDTH 8
+#elif defined(JMK_SIMD_SSE2)
+#define SIMD_WIDTH 4
+#else
+#define SIMD_WIDTH 1
+#endif
+
+void jmk::crossProduct2D(const PointBuffer2f& a, const PointBuffer2f& b, std::vector<float>& result)
+{
+	assert(a.size() == b.size());
+	const size_t size = a.size();
+	result.resize(size);
+
+	const float* ax = a.data(X), * ay = a.data(Y);
+	const float* bx = b.data(X), * by = b.data(Y);
+	float* out = result.data();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m256 r = _mm256_sub_ps(_mm256_mul_ps(_mm256_load_ps(ax + i), _mm256_load_ps(by + i)),
+			_mm256_mul_ps(_mm256_load_ps(ay + i), _mm256_load_ps(bx + i)));
+		_mm256_storeu_ps(out + i, r);
+	}
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m128 r = _mm_sub_ps(_mm_mul_ps(_mm_load_ps(ax + i), _mm_load_ps(by + i)),
+			_mm_mul_ps(_mm_load_ps(ay + i), _mm_load_ps(bx + i)));
+		_mm_storeu_ps(out + i, r);
+	}
+#endif
+	for (; i < size; i++)
+		out[i] = ax[i] * by[i] - ay[i] * bx[i];
+}
+
+void jmk::dotProduct(const PointBuffer2f& a, const PointBuffer2f& b, std::vector<float>& result)
+{
+	assert(a.size() == b.size());
+	const size_t size = a.size();
+	result.resize(size);
+
+	const float* ax = a.data(X), * ay = a.data(Y);
+	const float* bx = b.data(X), * by = b.data(Y);
+	float* out = result.data();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(ax + i), _mm256_load_ps(bx + i)),
+			_mm256_mul_ps(_mm256_load_ps(ay + i), _mm256_load_ps(by + i)));
+		_mm256_storeu_ps(out + i, r);
+	}
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m128 r = _mm_add_ps(_mm_mul_ps(_mm_load_ps(ax + i), _mm_load_ps(bx + i)),
+			_mm_mul_ps(_mm_load_ps(ay + i), _mm_load_ps(by + i)));
+		_mm_storeu_ps(out + i, r);
+	}
+#endif
+	for (; i < size; i++)
+		out[i] = ax[i] * bx[i] + ay[i] * by[i];
+}
+
+void jmk::dotProduct(const PointBuffer3f& a, const PointBuffer3f& b, std::vector<float>& result)
+{
+	assert(a.size() == b.size());
+	const size_t size = a.size();
+	result.resize(size);
+
+	const float* ax = a.data(X), * ay = a.data(Y), * az = a.data(Z);
+	const float* bx = b.data(X), * by = b.data(Y), * bz = b.data(Z);
+	float* out = result.data();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(ax + i), _mm256_load_ps(bx + i)),
+			_mm256_mul_ps(_mm256_load_ps(ay + i), _mm256_load_ps(by + i)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_load_ps(az + i), _mm256_load_ps(bz + i)));
+		_mm256_storeu_ps(out + i, r);
+	}
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m128 r = _mm_add_ps(_mm_mul_ps(_mm_load_ps(ax + i), _mm_load_ps(bx + i)),
+			_mm_mul_ps(_mm_load_ps(ay + i), _mm_load_ps(by + i)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(az + i), _mm_load_ps(bz + i)));
+		_mm_storeu_ps(out + i, r);
+	}
+#endif
+	for (; i < size; i++)
+		out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+}
+
+void jmk::magnitude(const PointBuffer2f& a, std::vector<float>& result)
+{
+	dotProduct(a, a, result);
+
+	float* out = result.data();
+	const size_t size = result.size();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_loadu_ps(out + i)));
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_loadu_ps(out + i)));
+#endif
+	for (; i < size; i++)
+		out[i] = sqrtf(out[i]);
+}
+
+void jmk::magnitude(const PointBuffer3f& a, std::vector<float>& result)
+{
+	dotProduct(a, a, result);
+
+	float* out = result.data();
+	const size_t size = result.size();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_loadu_ps(out + i)));
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_loadu_ps(out + i)));
+#endif
+	for (; i < size; i++)
+		out[i] = sqrtf(out[i]);
+}
+
+void jmk::normalize(PointBuffer2f& a)
+{
+	const size_t size = a.size();
+	float* ax = a.data(X), * ay = a.data(Y);
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m256 x = _mm256_load_ps(ax + i);
+		__m256 y = _mm256_load_ps(ay + i);
+		__m256 mag = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+		_mm256_store_ps(ax + i, _mm256_div_ps(x, mag));
+		_mm256_store_ps(ay + i, _mm256_div_ps(y, mag));
+	}
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m128 x = _mm_load_ps(ax + i);
+		__m128 y = _mm_load_ps(ay + i);
+		__m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+		_mm_store_ps(ax + i, _mm_div_ps(x, mag));
+		_mm_store_ps(ay + i, _mm_div_ps(y, mag));
+	}
+#endif
+	for (; i < size; i++)
+	{
+		float mag = sqrtf(ax[i] * ax[i] + ay[i] * ay[i]);
+		ax[i] /= mag;
+		ay[i] /= mag;
+	}
+}
+
+void jmk::normalize(PointBuffer3f& a)
+{
+	const size_t size = a.size();
+	float* ax = a.data(X), * ay = a.data(Y), * az = a.data(Z);
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m256 x = _mm256_load_ps(ax + i);
+		__m256 y = _mm256_load_ps(ay + i);
+		__m256 z = _mm256_load_ps(az + i);
+		__m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+		__m256 mag = _mm256_sqrt_ps(sum);
+		_mm256_store_ps(ax + i, _mm256_div_ps(x, mag));
+		_mm256_store_ps(ay + i, _mm256_div_ps(y, mag));
+		_mm256_store_ps(az + i, _mm256_div_ps(z, mag));
+	}
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+	{
+		__m128 x = _mm_load_ps(ax + i);
+		__m128 y = _mm_load_ps(ay + i);
+		__m128 z = _mm_load_ps(az + i);
+		__m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 mag = _mm_sqrt_ps(sum);
+		_mm_store_ps(ax + i, _mm_div_ps(x, mag));
+		_mm_store_ps(ay + i, _mm_div_ps(y, mag));
+		_mm_store_ps(az + i, _mm_div_ps(z, mag));
+	}
+#endif
+	for (; i < size; i++)
+	{
+		float mag = sqrtf(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+		ax[i] /= mag;
+		ay[i] /= mag;
+		az[i] /= mag;
+	}
+}
+
+// Component wise subtraction of one coordinate array. Shared by the 2D and 3D versions.
+static void subtract_array(const float* a, const float* b, float* out, size_t size)
+{
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm256_store_ps(out + i, _mm256_sub_ps(_mm256_load_ps(a + i), _mm256_load_ps(b + i)));
+#elif defined(JMK_SIMD_SSE2)
+	for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH)
+		_mm_store_ps(out + i, _mm_sub_ps(_mm_load_ps(a + i), _mm_load_ps(b + i)));
+#endif
+	for (; i < size; i++)
+		out[i] = a[i] - b[i];
+}
+
+void jmk::subtract(const PointBuffer2f& a, const PointBuffer2f& b, PointBuffer2f& result)
+{
+	assert(a.size() == b.size());
+	result.resize(a.size());
+	subtract_array(a.data(X), b.data(X), result.data(X), a.size());
+	subtract_array(a.data(Y), b.data(Y), result.data(Y), a.size());
+}
+
+void jmk::subtract(const PointBuffer3f& a, const PointBuffer3f& b, PointBuffer3f& result)
+{
+	assert(a.size() == b.size());
+	result.resize(a.size());
+	subtract_array(a.data(X), b.data(X), result.data(X), a.size());
+	subtract_array(a.data(Y), b.data(Y), result.data(Y), a.size());
+	subtract_array(a.data(Z), b.data(Z), result.data(Z), a.size());
+}
+
+PointBuffer2f jmk::operator-(const PointBuffer2f& a, const PointBuffer2f& b)
+{
+	PointBuffer2f result;
+	subtract(a, b, result);
+	return result;
+}
+
+PointBuffer3f jmk::operator-(const PointBuffer3f& a, const PointBuffer3f& b)
+{
+	PointBuffer3f result;
+	subtract(a, b, result);
+	return result;
+}
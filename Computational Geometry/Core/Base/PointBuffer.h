@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <new>
+
+#include "Vector.h"
+
+// Structure of arrays (SoA) point containers. Each coordinate lives in its own aligned array
+// so the batch kernels below can process several points per instruction.
+
+namespace jmk {
+
+#define SIMD_ALIGNMENT 32
+
+	// Minimal allocator that hands out SIMD_ALIGNMENT aligned blocks, so every coordinate array
+	// starts on a boundary suitable for aligned AVX / SSE loads.
+	template<typename T>
+	struct AlignedAllocator
+	{
+		typedef T value_type;
+
+		AlignedAllocator() {}
+
+		template<typename U>
+		AlignedAllocator(const AlignedAllocator<U>&) {}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(SIMD_ALIGNMENT)));
+		}
+
+		void deallocate(T* p, size_t)
+		{
+			::operator delete(p, std::align_val_t(SIMD_ALIGNMENT));
+		}
+
+		template<typename U>
+		bool operator==(const AlignedAllocator<U>&) const { return true; }
+
+		template<typename U>
+		bool operator!=(const AlignedAllocator<U>&) const { return false; }
+	};
+
+	template <typename coordinate_type, size_t dimensions = DIM3>
+	class PointBuffer
+	{
+		typedef std::vector<coordinate_type, AlignedAllocator<coordinate_type>> CoordArray;
+
+		std::array<CoordArray, dimensions> coords;
+
+	public:
+		PointBuffer() {}
+
+		explicit PointBuffer(size_t _size)
+		{
+			resize(_size);
+		}
+
+		// Build the buffer from the usual array of structures representation
+		PointBuffer(const std::vector<Vector<coordinate_type, dimensions>>& _points)
+		{
+			resize(_points.size());
+			for (size_t i = 0; i < _points.size(); i++)
+				set(i, _points[i]);
+		}
+
+		size_t size() const
+		{
+			return coords[X].size();
+		}
+
+		void resize(size_t _size)
+		{
+			for (auto& arr : coords)
+				arr.resize(_size);
+		}
+
+		void reserve(size_t _size)
+		{
+			for (auto& arr : coords)
+				arr.reserve(_size);
+		}
+
+		void push_back(const Vector<coordinate_type, dimensions>& _point)
+		{
+			for (size_t i = 0; i < dimensions; i++)
+				coords[i].push_back(_point[i]);
+		}
+
+		// Gather the point at the given index back in to a Vector
+		Vector<coordinate_type, dimensions> get(size_t _index) const
+		{
+			std::array<coordinate_type, dimensions> temp_array;
+			for (size_t i = 0; i < dimensions; i++)
+				temp_array[i] = coords[i][_index];
+			return Vector<coordinate_type, dimensions>(temp_array);
+		}
+
+		void set(size_t _index, const Vector<coordinate_type, dimensions>& _point)
+		{
+			for (size_t i = 0; i < dimensions; i++)
+				coords[i][_index] = _point[i];
+		}
+
+		// Returns the contiguous array holding the given component (X, Y or Z) of all the points
+		coordinate_type* data(const unsigned int _dim)
+		{
+			return coords[_dim].data();
+		}
+
+		const coordinate_type* data(const unsigned int _dim) const
+		{
+			return coords[_dim].data();
+		}
+	};
+
+	typedef PointBuffer<float, DIM2>	PointBuffer2f;
+	typedef PointBuffer<float, DIM3>	PointBuffer3f;
+
+	// Batch versions of the Vector operations. Every function works element wise over the whole
+	// buffers, which must have the same size (asserted). Results are written in to the given output
+	// which is resized as needed. The instruction set is picked in Simd.h.
+
+	// result[i] = a[i] x b[i]
+	void crossProduct2D(const PointBuffer2f& a, const PointBuffer2f& b, std::vector<float>& result);
+
+	// result[i] = a[i] . b[i]
+	void dotProduct(const PointBuffer2f& a, const PointBuffer2f& b, std::vector<float>& result);
+	void dotProduct(const PointBuffer3f& a, const PointBuffer3f& b, std::vector<float>& result);
+
+	// result[i] = |a[i]|
+	void magnitude(const PointBuffer2f& a, std::vector<float>& result);
+	void magnitude(const PointBuffer3f& a, std::vector<float>& result);
+
+	// Normalize every vector in the buffer in place
+	void normalize(PointBuffer2f& a);
+	void normalize(PointBuffer3f& a);
+
+	// result[i] = a[i] - b[i]
+	void subtract(const PointBuffer2f& a, const PointBuffer2f& b, PointBuffer2f& result);
+	void subtract(const PointBuffer3f& a, const PointBuffer3f& b, PointBuffer3f& result);
+
+	PointBuffer2f operator-(const PointBuffer2f& a, const PointBuffer2f& b);
+	PointBuffer3f operator-(const PointBuffer3f& a, const PointBuffer3f& b);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <type_traits>
+
+#include "Vector.h"
+
+// Spatial hash of points on a uniform grid, used to find a point by its coordinates in expected
+// O(1) instead of scanning the whole list. Only indices are stored, the caller keeps the points.
+// Matching follows Vector::operator==, two points match when every coordinate differs by less than
+// TOLERANCE. The grid cells are larger than TOLERANCE, so a query only probes the one or two cells
+// per axis that its tolerance box overlaps.
+
+namespace jmk {
+
+#define POINT_HASH_CELL (4 * TOLERANCE)
+#define POINT_HASH_NOT_FOUND UINT32_MAX
+
+	template <typename coordinate_type, size_t dimensions = DIM3>
+	class PointHash
+	{
+		typedef std::array<int64_t, dimensions> Cell;
+
+		// Key of the cell -> index of the point. Different cells can share a key, the candidates are
+		// always checked against the query so a collision only costs a comparison.
+		std::unordered_multimap<size_t, uint32_t> cells;
+
+		// Cell coordinate along one axis. Integer coordinates compare exactly, so the coordinate
+		// itself is the cell. Very large floating point values are clamped in to the edge cells, which
+		// keeps the lookups correct but makes them slower far away from the origin.
+		static int64_t snap(double _value)
+		{
+			if constexpr (std::is_integral<coordinate_type>::value)
+				return (int64_t)_value;
+			else
+			{
+				double cell = std::floor(_value / POINT_HASH_CELL);
+				if (cell > 4.0e18) return INT64_C(4000000000000000000);
+				if (cell < -4.0e18) return -INT64_C(4000000000000000000);
+				return (int64_t)cell;
+			}
+		}
+
+		static size_t key(const Cell& _cell)
+		{
+			uint64_t h = 0;
+			for (size_t i = 0; i < dimensions; i++)
+				h = (h ^ (uint64_t)_cell[i]) * UINT64_C(0x9E3779B97F4A7C15) + (h >> 29);
+			return (size_t)h;
+		}
+
+	public:
+		void clear()
+		{
+			cells.clear();
+		}
+
+		void reserve(size_t _count)
+		{
+			cells.reserve(_count);
+		}
+
+		size_t size() const
+		{
+			return cells.size();
+		}
+
+		void insert(const Vector<coordinate_type, dimensions>& _point, uint32_t _index)
+		{
+			Cell cell;
+			for (size_t i = 0; i < dimensions; i++)
+				cell[i] = snap(_point[i]);
+			cells.emplace(key(cell), _index);
+		}
+
+		// Smallest stored index whose point equals _point, or POINT_HASH_NOT_FOUND.
+		// _point_at(index) must return the point stored under that index.
+		template<class PointAt>
+		uint32_t find(const Vector<coordinate_type, dimensions>& _point, PointAt _point_at) const
+		{
+			// Range of cells touched by the tolerance box around the point, along each axis
+			Cell low, high;
+			for (size_t i = 0; i < dimensions; i++)
+			{
+				if constexpr (std::is_integral<coordinate_type>::value)
+					low[i] = high[i] = snap(_point[i]);
+				else
+				{
+					low[i] = snap((double)_point[i] - TOLERANCE);
+					high[i] = snap((double)_point[i] + TOLERANCE);
+				}
+			}
+
+			uint32_t found = POINT_HASH_NOT_FOUND;
+			Cell cell = low;
+			while (true)
+			{
+				auto range = cells.equal_range(key(cell));
+				for (auto it = range.first; it != range.second; ++it)
+					if (it->second < found && _point == _point_at(it->second))
+						found = it->second;
+
+				// Step to the next cell of the box
+				size_t i = 0;
+				for (; i < dimensions; i++)
+				{
+					if (cell[i] < high[i])
+					{
+						cell[i]++;
+						break;
+					}
+					cell[i] = low[i];
+				}
+				if (i == dimensions)
+					break;
+			}
+			return found;
+		}
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+
+#include "Vector.h"
+
+// Non-owning views over external coordinate arrays. A view only stores a pointer, a count and a
+// stride, so a flat float* / double* buffer (renderer output, memory mapped file) can be handed to
+// the algorithms without copying it in to Vectors first.
+
+namespace jmk {
+
+	template <typename coordinate_type, size_t dimensions = DIM3>
+	class PointView
+	{
+		const coordinate_type* base = nullptr;
+		size_t count = 0;
+		size_t step = dimensions;		// Distance between two consecutive points, in coordinates
+
+	public:
+		PointView() {}
+
+		// View over count points starting at _base. _stride is the number of coordinates from one point
+		// to the next, it is larger than the dimension when the points are interleaved with other data.
+		PointView(const coordinate_type* _base, size_t _count, size_t _stride = dimensions)
+			: base(_base), count(_count), step(_stride) {}
+
+		// View over packed vectors. The vector must outlive the view.
+		PointView(const std::vector<Vector<coordinate_type, dimensions>>& _points)
+			: base(_points.empty() ? nullptr : _points[0].data()), count(_points.size()) {}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		size_t stride() const
+		{
+			return step;
+		}
+
+		const coordinate_type* data() const
+		{
+			return base;
+		}
+
+		// Vector is exactly its coordinates (see the layout checks in Vector.h), so every point of the
+		// buffer can be referenced in place as a Vector.
+		const Vector<coordinate_type, dimensions>& operator[](size_t _index) const
+		{
+			return *reinterpret_cast<const Vector<coordinate_type, dimensions>*>(base + _index * step);
+		}
+
+		// Sub view over the points [_first, _first + _count)
+		PointView subview(size_t _first, size_t _count) const
+		{
+			return PointView(base + _first * step, _count, step);
+		}
+	};
+
+	template<typename coordinate_type>
+	using PointView2 = PointView<coordinate_type, DIM2>;
+
+	template<typename coordinate_type>
+	using PointView3 = PointView<coordinate_type, DIM3>;
+
+	typedef PointView<float, DIM2>		PointView2f;
+	typedef PointView<float, DIM3>		PointView3f;
+	typedef PointView<double, DIM2>		PointView2lf;
+	typedef PointView<double, DIM3>		PointView3lf;
+	typedef PointView<int32_t, DIM2>	PointView2i;
+}
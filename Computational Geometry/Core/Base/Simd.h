@@ -0,0 +1,13 @@
+#pragma once
+
+// Instruction set selection shared by the batch kernels. AVX2 is used when the translation unit is
+// compiled with it (/arch:AVX2 or -mavx2), otherwise SSE2, otherwise the kernels fall back to plain
+// scalar loops. The Visual Studio project builds every configuration with /arch:AVX2.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JMK_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JMK_SIMD_SSE2
+#endif
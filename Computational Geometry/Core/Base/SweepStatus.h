@@ -0,0 +1,502 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Ordered container for the status of a plane sweep (the active edges, left to right, at the current
+// sweep position). It is a B+-tree whose nodes live in two pools, so inserting and erasing do not
+// allocate once the pools have grown, and a search touches one node per level instead of one per
+// compared element as in std::set.
+//
+// The order of the elements usually depends on the sweep position, the comparator reads it from
+// outside. So the tree never keeps a copy of an erased element as a separator: every inner node
+// stores the largest live element of each child and these are updated as elements come and go.
+// As with std::set the elements are unique under the comparator, inserting an element equivalent to
+// one already there does nothing. Nodes are removed once empty but never merged, so the height is
+// bounded by the largest size the container has had.
+
+namespace jmk {
+
+#define SWEEP_STATUS_NONE UINT32_MAX
+
+	template <typename T, typename Compare, size_t B = 64>
+	class SweepStatus
+	{
+		static_assert(B >= 4, "Nodes must hold at least 4 entries");
+
+		struct Leaf
+		{
+			T items[B];
+			uint32_t count = 0;
+			uint32_t parent = SWEEP_STATUS_NONE;
+			uint32_t prev = SWEEP_STATUS_NONE;
+			uint32_t next = SWEEP_STATUS_NONE;
+		};
+
+		struct Inner
+		{
+			T maxes[B];                 // Largest element under each child
+			uint32_t children[B];
+			uint32_t count = 0;
+			uint32_t parent = SWEEP_STATUS_NONE;
+			bool leaf_children = false;
+		};
+
+		std::vector<Leaf> leaves;
+		std::vector<Inner> inners;
+		std::vector<uint32_t> free_leaves;
+		std::vector<uint32_t> free_inners;
+
+		uint32_t root = SWEEP_STATUS_NONE;
+		uint32_t height = 0;        // Number of inner levels, 0 when the root is a leaf
+		uint32_t first_leaf = SWEEP_STATUS_NONE;
+		uint32_t last_leaf = SWEEP_STATUS_NONE;
+		size_t element_count = 0;
+		Compare less;
+
+		uint32_t newLeaf()
+		{
+			if (!free_leaves.empty())
+			{
+				uint32_t id = free_leaves.back();
+				free_leaves.pop_back();
+				leaves[id] = Leaf();
+				return id;
+			}
+			leaves.emplace_back();
+			return (uint32_t)leaves.size() - 1;
+		}
+
+		uint32_t newInner()
+		{
+			if (!free_inners.empty())
+			{
+				uint32_t id = free_inners.back();
+				free_inners.pop_back();
+				inners[id] = Inner();
+				return id;
+			}
+			inners.emplace_back();
+			return (uint32_t)inners.size() - 1;
+		}
+
+		uint32_t parentOf(uint32_t node, bool is_leaf) const
+		{
+			return is_leaf ? leaves[node].parent : inners[node].parent;
+		}
+
+		void setParent(uint32_t node, bool is_leaf, uint32_t parent)
+		{
+			if (is_leaf)
+				leaves[node].parent = parent;
+			else
+				inners[node].parent = parent;
+		}
+
+		const T& maxOf(uint32_t node, bool is_leaf) const
+		{
+			return is_leaf ? leaves[node].items[leaves[node].count - 1] : inners[node].maxes[inners[node].count - 1];
+		}
+
+		uint32_t slotOf(uint32_t parent, uint32_t child) const
+		{
+			const Inner& p = inners[parent];
+			uint32_t slot = 0;
+			while (p.children[slot] != child)
+				slot++;
+			return slot;
+		}
+
+		// Store the current largest element of node in its parent, and further up while node is the
+		// last child
+		void refreshMax(uint32_t node, bool is_leaf)
+		{
+			uint32_t parent = parentOf(node, is_leaf);
+			while (parent != SWEEP_STATUS_NONE)
+			{
+				uint32_t slot = slotOf(parent, node);
+				inners[parent].maxes[slot] = maxOf(node, is_leaf);
+				if (slot + 1 != inners[parent].count)
+					return;
+				node = parent;
+				is_leaf = false;
+				parent = inners[node].parent;
+			}
+		}
+
+		// Put child right after left in left's parent, growing the tree when left is the root
+		void insertChild(uint32_t left, uint32_t child, bool is_leaf)
+		{
+			uint32_t parent = parentOf(left, is_leaf);
+			if (parent == SWEEP_STATUS_NONE)
+			{
+				parent = newInner();
+				Inner& r = inners[parent];
+				r.leaf_children = is_leaf;
+				r.count = 2;
+				r.children[0] = left;
+				r.children[1] = child;
+				r.maxes[0] = maxOf(left, is_leaf);
+				r.maxes[1] = maxOf(child, is_leaf);
+				setParent(left, is_leaf, parent);
+				setParent(child, is_leaf, parent);
+				root = parent;
+				height++;
+				return;
+			}
+
+			uint32_t slot = slotOf(parent, left) + 1;
+			if (inners[parent].count == B)
+			{
+				// Move the upper half to a new node and insert in to the half the slot falls in
+				uint32_t sibling = newInner();
+				Inner& p = inners[parent];
+				Inner& s = inners[sibling];
+				const uint32_t keep = B / 2;
+				s.leaf_children = p.leaf_children;
+				s.count = B - keep;
+				for (uint32_t i = keep; i < B; i++)
+				{
+					s.children[i - keep] = p.children[i];
+					s.maxes[i - keep] = p.maxes[i];
+					setParent(p.children[i], is_leaf, sibling);
+				}
+				p.count = keep;
+
+				if (slot > keep)
+				{
+					setParent(child, is_leaf, sibling);
+					insertAt(sibling, slot - keep, child, is_leaf);
+				}
+				else
+				{
+					setParent(child, is_leaf, parent);
+					insertAt(parent, slot, child, is_leaf);
+				}
+				insertChild(parent, sibling, false);
+				refreshMax(parent, false);
+				return;
+			}
+
+			setParent(child, is_leaf, parent);
+			insertAt(parent, slot, child, is_leaf);
+		}
+
+		void insertAt(uint32_t parent, uint32_t slot, uint32_t child, bool is_leaf)
+		{
+			Inner& p = inners[parent];
+			for (uint32_t i = p.count; i > slot; i--)
+			{
+				p.children[i] = p.children[i - 1];
+				p.maxes[i] = p.maxes[i - 1];
+			}
+			p.children[slot] = child;
+			p.maxes[slot] = maxOf(child, is_leaf);
+			p.count++;
+			if (slot + 1 == p.count)
+				refreshMax(parent, false);
+		}
+
+		// Take child out of its parent, dropping nodes left empty
+		void removeChild(uint32_t child, bool is_leaf)
+		{
+			uint32_t parent = parentOf(child, is_leaf);
+			if (parent == SWEEP_STATUS_NONE)
+			{
+				root = SWEEP_STATUS_NONE;
+				height = 0;
+				return;
+			}
+
+			Inner& p = inners[parent];
+			uint32_t slot = slotOf(parent, child);
+			for (uint32_t i = slot + 1; i < p.count; i++)
+			{
+				p.children[i - 1] = p.children[i];
+				p.maxes[i - 1] = p.maxes[i];
+			}
+			p.count--;
+
+			if (p.count == 0)
+			{
+				removeChild(parent, false);
+				free_inners.push_back(parent);
+			}
+			else if (slot == p.count)
+				refreshMax(parent, false);
+		}
+
+		// Drop root levels with a single child
+		void shrink()
+		{
+			while (height > 0 && inners[root].count == 1)
+			{
+				uint32_t old_root = root;
+				root = inners[old_root].children[0];
+				height--;
+				setParent(root, height == 0, SWEEP_STATUS_NONE);
+				free_inners.push_back(old_root);
+			}
+		}
+
+	public:
+		class iterator
+		{
+			friend class SweepStatus;
+
+			const SweepStatus* status = nullptr;
+			uint32_t leaf = SWEEP_STATUS_NONE;
+			uint32_t position = 0;
+
+			iterator(const SweepStatus* _status, uint32_t _leaf, uint32_t _position)
+				: status(_status), leaf(_leaf), position(_position) {}
+
+		public:
+			iterator() {}
+
+			const T& operator*() const { return status->leaves[leaf].items[position]; }
+
+			iterator& operator++()
+			{
+				if (++position == status->leaves[leaf].count)
+				{
+					leaf = status->leaves[leaf].next;
+					position = 0;
+				}
+				return *this;
+			}
+
+			// Decrementing end() gives the last element
+			iterator& operator--()
+			{
+				if (leaf == SWEEP_STATUS_NONE)
+				{
+					leaf = status->last_leaf;
+					position = status->leaves[leaf].count - 1;
+				}
+				else if (position == 0)
+				{
+					leaf = status->leaves[leaf].prev;
+					position = status->leaves[leaf].count - 1;
+				}
+				else
+					position--;
+				return *this;
+			}
+
+			bool operator==(const iterator& _other) const { return leaf == _other.leaf && position == _other.position; }
+			bool operator!=(const iterator& _other) const { return !(*this == _other); }
+		};
+
+		explicit SweepStatus(Compare _less = Compare()) : less(_less) {}
+
+		size_t size() const { return element_count; }
+		bool empty() const { return element_count == 0; }
+
+		iterator begin() const { return iterator(this, first_leaf, 0); }
+		iterator end() const { return iterator(this, SWEEP_STATUS_NONE, 0); }
+
+		// Keeps the pools, so a container reused across sweeps stops allocating
+		void clear()
+		{
+			leaves.clear();
+			inners.clear();
+			free_leaves.clear();
+			free_inners.clear();
+			root = first_leaf = last_leaf = SWEEP_STATUS_NONE;
+			height = 0;
+			element_count = 0;
+		}
+
+		// First element not less than key
+		iterator lower_bound(const T& key) const
+		{
+			if (root == SWEEP_STATUS_NONE)
+				return end();
+
+			uint32_t node = root;
+			for (uint32_t level = height; level > 0; level--)
+			{
+				const Inner& n = inners[node];
+				uint32_t low = 0, high = n.count;
+				while (low < high)
+				{
+					uint32_t mid = (low + high) / 2;
+					if (less(n.maxes[mid], key))
+						low = mid + 1;
+					else
+						high = mid;
+				}
+				if (low == n.count)
+					return end();
+				node = n.children[low];
+			}
+
+			const Leaf& l = leaves[node];
+			uint32_t low = 0, high = l.count;
+			while (low < high)
+			{
+				uint32_t mid = (low + high) / 2;
+				if (less(l.items[mid], key))
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			if (low == l.count)
+				return end();
+			return iterator(this, node, low);
+		}
+
+		// Element equivalent to key, or end()
+		iterator find(const T& key) const
+		{
+			iterator it = lower_bound(key);
+			if (it != end() && !less(key, *it))
+				return it;
+			return end();
+		}
+
+		// Last element less than key, or end() if there is none. In a sweep, the edge directly to the
+		// left of a point.
+		iterator predecessor(const T& key) const
+		{
+			if (empty())
+				return end();
+			iterator it = lower_bound(key);
+			if (it == begin())
+				return end();
+			return --it;
+		}
+
+		std::pair<iterator, bool> insert(const T& value)
+		{
+			if (root == SWEEP_STATUS_NONE)
+			{
+				root = first_leaf = last_leaf = newLeaf();
+				leaves[root].items[0] = value;
+				leaves[root].count = 1;
+				element_count = 1;
+				return { iterator(this, root, 0), true };
+			}
+
+			// Go down to the first child whose largest element is not less than value, or the last one
+			uint32_t node = root;
+			for (uint32_t level = height; level > 0; level--)
+			{
+				const Inner& n = inners[node];
+				uint32_t low = 0, high = n.count - 1;
+				while (low < high)
+				{
+					uint32_t mid = (low + high) / 2;
+					if (less(n.maxes[mid], value))
+						low = mid + 1;
+					else
+						high = mid;
+				}
+				node = n.children[low];
+			}
+
+			uint32_t position = 0;
+			{
+				const Leaf& l = leaves[node];
+				uint32_t high = l.count;
+				while (position < high)
+				{
+					uint32_t mid = (position + high) / 2;
+					if (less(l.items[mid], value))
+						position = mid + 1;
+					else
+						high = mid;
+				}
+				if (position < l.count && !less(value, l.items[position]))
+					return { iterator(this, node, position), false };
+			}
+
+			return { insertIn(node, position, value), true };
+		}
+
+		// Put value after the last element without comparing, the caller makes sure it belongs there.
+		// Fills the container from a sequence that is already in order, e.g. a sweep line started
+		// part way down.
+		void append(const T& value)
+		{
+			if (root == SWEEP_STATUS_NONE)
+				insert(value);
+			else
+				insertIn(last_leaf, leaves[last_leaf].count, value);
+		}
+
+		void erase(iterator it)
+		{
+			uint32_t node = it.leaf;
+			Leaf& l = leaves[node];
+			for (uint32_t i = it.position + 1; i < l.count; i++)
+				l.items[i - 1] = l.items[i];
+			l.count--;
+			element_count--;
+
+			if (l.count == 0)
+			{
+				if (l.prev != SWEEP_STATUS_NONE)
+					leaves[l.prev].next = l.next;
+				else
+					first_leaf = l.next;
+				if (l.next != SWEEP_STATUS_NONE)
+					leaves[l.next].prev = l.prev;
+				else
+					last_leaf = l.prev;
+
+				removeChild(node, true);
+				free_leaves.push_back(node);
+				if (root != SWEEP_STATUS_NONE)
+					shrink();
+			}
+			else if (it.position == l.count)
+				refreshMax(node, true);
+		}
+
+	private:
+		// Put value at position of the leaf, splitting it when full
+		iterator insertIn(uint32_t node, uint32_t position, const T& value)
+		{
+			if (leaves[node].count == B)
+			{
+				// Split the leaf, the upper half goes to a new leaf linked after it
+				uint32_t sibling = newLeaf();
+				Leaf& l = leaves[node];
+				Leaf& s = leaves[sibling];
+				const uint32_t keep = B / 2;
+				for (uint32_t i = keep; i < B; i++)
+					s.items[i - keep] = l.items[i];
+				s.count = B - keep;
+				l.count = keep;
+				s.prev = node;
+				s.next = l.next;
+				if (l.next != SWEEP_STATUS_NONE)
+					leaves[l.next].prev = sibling;
+				else
+					last_leaf = sibling;
+				l.next = sibling;
+
+				insertChild(node, sibling, true);
+				refreshMax(node, true);
+
+				if (position > keep)
+				{
+					node = sibling;
+					position -= keep;
+				}
+			}
+
+			Leaf& l = leaves[node];
+			for (uint32_t i = l.count; i > position; i--)
+				l.items[i] = l.items[i - 1];
+			l.items[position] = value;
+			l.count++;
+			element_count++;
+			if (position + 1 == l.count)
+				refreshMax(node, true);
+			return iterator(this, node, position);
+		}
+	};
+}
@@ -1,27 +1,36 @@
 #include "Vector.h"
+#include "Simd.h"
 
 
 
 
-float jmk::crossProduct2D(jmk::Vector2f v1, jmk::Vector2f v2)
+float jmk::dotProduct(const Vector3fA& a, const Vector3fA& b)
 {
-	return v1[X] * v2[Y] - v1[Y] * v2[X];
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	__m128 m = _mm_mul_ps(_mm_load_ps(a.data()), _mm_load_ps(b.data()));
+	// Same summation order as the scalar version, x + y + z, the padding lane is ignored
+	__m128 sum = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2)));
+	return _mm_cvtss_f32(sum);
+#else
+	return dotProduct(a.vec, b.vec);
+#endif
 }
 
-jmk::Vector3f jmk::crossProduct3D(jmk::Vector3f v1, jmk::Vector3f v2)
+jmk::Vector3fA jmk::crossProduct3D(const Vector3fA& a, const Vector3fA& b)
 {
-	float x_, y_, z_;
-	x_ = v1[Y] * v2[Z] - v2[Y] * v1[Z];
-	y_ = -(v2[Z] * v1[X] - v1[Z] * v2[X]);  // es lo mimso y_ = v1[Z] * v2[X] - v1[X] * v2[Z];
-	z_ = v1[X] * v2[Y] - v2[X] * v1[Y];
-
-	return Vector3f(x_, y_, z_);
-}
-
-float jmk::scalerTripleProduct(Vector3f v1, Vector3f v2, Vector3f v3)
-{
-	auto bc_cross = crossProduct3D(v2, v3);
-
-	return dotProduct(v1, bc_cross);
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	// a x b = (a * b.yzx - a.yzx * b).yzx, the padding lane stays 0
+	__m128 va = _mm_load_ps(a.data());
+	__m128 vb = _mm_load_ps(b.data());
+	__m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(va, b_yzx), _mm_mul_ps(a_yzx, vb));
+
+	Vector3fA result;
+	_mm_store_ps(reinterpret_cast<float*>(&result), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+	return result;
+#else
+	return Vector3fA(crossProduct3D(a.vec, b.vec));
+#endif
 }
-
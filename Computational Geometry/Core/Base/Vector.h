@@ -233,6 +233,8 @@ namespace jmk
 
 #pragma once
 #include <array>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 
 // TODO : Vector should move to ../Core
@@ -254,20 +256,22 @@ namespace jmk {
 		static_assert(std::is_arithmetic_v<coordinate_type>, "Vector class can only store integral or floating points values");
 		static_assert(dimensions >= DIM2, "Vector dimension atleast should be 2D");
 
+		// The coordinates are the only member, see the layout checks below the typedefs
 		std::array<coordinate_type, dimensions> coords = {};
-		bool is_normalized = false;
 
 		template<typename coordinate_type, size_t dimensions>
-		friend float dotProduct(const Vector<coordinate_type, dimensions>& v1, const Vector<coordinate_type, dimensions>& v2);
+		friend constexpr real_t<coordinate_type> dotProduct(const Vector<coordinate_type, dimensions>& v1, const Vector<coordinate_type, dimensions>& v2);
 
 	public:
-		Vector() {}
+		// Every arithmetic operation is constexpr and writes straight in to the result, so chains like
+		// a + b * t compile down to one loop per component and can be evaluated at compile time.
+		constexpr Vector() {}
 
-		Vector(std::array<coordinate_type, dimensions> _coords) : coords(_coords) {}
+		constexpr Vector(std::array<coordinate_type, dimensions> _coords) : coords(_coords) {}
 
-		Vector(coordinate_type _x, coordinate_type _y, coordinate_type _z) : coords({ _x,_y,_z }) {}
+		constexpr Vector(coordinate_type _x, coordinate_type _y, coordinate_type _z) : coords({ _x,_y,_z }) {}
 
-		Vector(coordinate_type _x, coordinate_type _y) : coords({ _x,_y }) {}
+		constexpr Vector(coordinate_type _x, coordinate_type _y) : coords({ _x,_y }) {}
 
 		//Vector(const Vector<coordinate_type, other_dimensions>&);
 
@@ -278,21 +282,30 @@ namespace jmk {
 		bool operator!=(const Vector<coordinate_type, dimensions>&) const;
 
 		// Less than operator for comparison
-		bool operator<(const Vector<coordinate_type, dimensions>&) const;
+		constexpr bool operator<(const Vector<coordinate_type, dimensions>&) const;
 
 		// Greater than operator for comparison
 		bool operator>(const Vector<coordinate_type, dimensions>&) const;
 
-		Vector<coordinate_type, dimensions> operator*(coordinate_type value);
+		constexpr Vector<coordinate_type, dimensions> operator*(coordinate_type value) const;
 
 		// Substraction operator. Substract x and y component separately.
-		Vector<coordinate_type, dimensions> operator-(const Vector<coordinate_type, dimensions>&) const;
+		constexpr Vector<coordinate_type, dimensions> operator-(const Vector<coordinate_type, dimensions>&) const;
 
-		// Greater than operator for comparison
-		Vector<coordinate_type, dimensions> operator+(const Vector<coordinate_type, dimensions>&) const;
+		// Addition operator. Add each component separately.
+		constexpr Vector<coordinate_type, dimensions> operator+(const Vector<coordinate_type, dimensions>&) const;
+
+		// In place versions, no new Vector is created
+		constexpr Vector<coordinate_type, dimensions>& operator*=(coordinate_type value);
 
-		//TODO make this to modifiable
-		coordinate_type operator[](const unsigned int) const;
+		constexpr Vector<coordinate_type, dimensions>& operator-=(const Vector<coordinate_type, dimensions>&);
+
+		constexpr Vector<coordinate_type, dimensions>& operator+=(const Vector<coordinate_type, dimensions>&);
+
+		// Bounds are only checked in debug builds
+		constexpr coordinate_type operator[](const unsigned int) const;
+
+		constexpr coordinate_type& operator[](const unsigned int);
 
 		// Dot product
 		float dot(Vector<coordinate_type, dimensions>& v1, Vector<coordinate_type, dimensions>& v2);
@@ -300,20 +313,59 @@ namespace jmk {
 		// Cross product
 		Vector<coordinate_type, dimensions> cross(const Vector<coordinate_type, dimensions>&);
 
-		void assign(const unsigned int dim, coordinate_type value);
+		constexpr void assign(const unsigned int dim, coordinate_type value);
 
 		// Return the magnitude of the the vector (mod(A) / |A|)
-		float magnitude() const;
+		real_t<coordinate_type> magnitude() const;
 
 		// Normalize the vector
 		void normalize();
 
-		// Returns the underline array object 
-		std::array<coordinate_type, dimensions> data();
+		// Returns a pointer to the coordinates
+		constexpr coordinate_type* data();
+
+		constexpr const coordinate_type* data() const;
 	};
 
 	typedef Vector<float, DIM2>		Vector2f;
 	typedef Vector<float, DIM3>		Vector3f;
+	typedef Vector<int32_t, DIM2>	Vector2i;
+	typedef Vector<double, DIM2>	Vector2lf;
+	typedef Vector<double, DIM3>	Vector3lf;
+
+	// Arrays of vectors are reinterpreted as packed coordinates by the SIMD kernels, so a Vector must
+	// stay exactly its coordinates with no padding or extra members.
+	static_assert(sizeof(Vector2f) == 2 * sizeof(float) && alignof(Vector2f) == alignof(float), "Vector2f must be two packed floats");
+	static_assert(sizeof(Vector3f) == 3 * sizeof(float) && alignof(Vector3f) == alignof(float), "Vector3f must be three packed floats");
+	static_assert(sizeof(Vector2i) == 2 * sizeof(int32_t), "Vector2i must be two packed int32");
+	static_assert(sizeof(Vector2lf) == 2 * sizeof(double) && sizeof(Vector3lf) == 3 * sizeof(double), "double vectors must be packed");
+	static_assert(std::is_trivially_copyable_v<Vector2f> && std::is_trivially_copyable_v<Vector3f>, "Vectors must be trivially copyable");
+
+	// 3D vector padded to 16 bytes and aligned to 16, so it can be loaded with one aligned SSE load.
+	// Use it for arrays that go through SIMD code, Vector3f stays the compact 12 byte type.
+	// The padding lane is kept at zero.
+	struct alignas(16) Vector3fA
+	{
+		Vector3f vec;
+		float pad = 0.0f;
+
+		constexpr Vector3fA() {}
+
+		constexpr Vector3fA(const Vector3f& _vec) : vec(_vec) {}
+
+		constexpr Vector3fA(float _x, float _y, float _z) : vec(_x, _y, _z) {}
+
+		constexpr operator Vector3f() const { return vec; }
+
+		constexpr float operator[](const unsigned int _index) const { return vec[_index]; }
+
+		constexpr float& operator[](const unsigned int _index) { return vec[_index]; }
+
+		// Returns the 4 floats x, y, z and the padding lane
+		const float* data() const { return reinterpret_cast<const float*>(this); }
+	};
+
+	static_assert(sizeof(Vector3fA) == 16 && alignof(Vector3fA) == 16, "Vector3fA must be one aligned SSE register");
 
 
 	template<typename coordinate_type, size_t dimensions>
@@ -336,7 +388,7 @@ namespace jmk {
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline bool Vector<coordinate_type, dimensions>::operator<(const Vector<coordinate_type, dimensions>& _other) const
+	constexpr bool Vector<coordinate_type, dimensions>::operator<(const Vector<coordinate_type, dimensions>& _other) const
 	{
 		for (size_t i = 0; i < dimensions; i++)
 		{
@@ -359,69 +411,100 @@ namespace jmk {
 	}
 
 	template<typename coordinate_type, size_t dimensions>
-	inline Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator*(coordinate_type value)
+	constexpr Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator*(coordinate_type value) const
 	{
-		std::array<coordinate_type, dimensions> temp_array;
+		Vector<coordinate_type, dimensions> result;
 
-		for (int i = 0; i < dimensions; i++)
-			temp_array[i] = coords[i] * value;
+		for (size_t i = 0; i < dimensions; i++)
+			result.coords[i] = coords[i] * value;
 
-		return Vector<coordinate_type, dimensions>(temp_array);
+		return result;
 	}
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator-(const Vector<coordinate_type, dimensions>& _other) const
+	constexpr Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator-(const Vector<coordinate_type, dimensions>& _other) const
 	{
-		std::array<coordinate_type, dimensions> temp_array;
+		Vector<coordinate_type, dimensions> result;
 
-		for (int i = 0; i < dimensions; i++)
-			temp_array[i] = coords[i] - _other.coords[i];
+		for (size_t i = 0; i < dimensions; i++)
+			result.coords[i] = coords[i] - _other.coords[i];
 
-		return Vector<coordinate_type, dimensions>(temp_array);
+		return result;
 	}
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator+(const Vector<coordinate_type, dimensions>& _other) const
+	constexpr Vector<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::operator+(const Vector<coordinate_type, dimensions>& _other) const
 	{
-		std::array<coordinate_type, dimensions> temp_array;
+		Vector<coordinate_type, dimensions> result;
 
-		for (int i = 0; i < dimensions; i++)
-			temp_array[i] = coords[i] + _other.coords[i];
+		for (size_t i = 0; i < dimensions; i++)
+			result.coords[i] = coords[i] + _other.coords[i];
 
-		return Vector<coordinate_type, dimensions>(temp_array);
+		return result;
 	}
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline coordinate_type Vector<coordinate_type, dimensions>::operator[](const unsigned int _index) const
+	constexpr Vector<coordinate_type, dimensions>& Vector<coordinate_type, dimensions>::operator*=(coordinate_type value)
 	{
-		if (_index >= coords.size()) {
-			std::cout << "Index out of bounds";
-			return coordinate_type();
-		}
+		for (size_t i = 0; i < dimensions; i++)
+			coords[i] *= value;
+
+		return *this;
+	}
+
+
+	template<typename coordinate_type, size_t dimensions>
+	constexpr Vector<coordinate_type, dimensions>& Vector<coordinate_type, dimensions>::operator-=(const Vector<coordinate_type, dimensions>& _other)
+	{
+		for (size_t i = 0; i < dimensions; i++)
+			coords[i] -= _other.coords[i];
+
+		return *this;
+	}
+
 
+	template<typename coordinate_type, size_t dimensions>
+	constexpr Vector<coordinate_type, dimensions>& Vector<coordinate_type, dimensions>::operator+=(const Vector<coordinate_type, dimensions>& _other)
+	{
+		for (size_t i = 0; i < dimensions; i++)
+			coords[i] += _other.coords[i];
+
+		return *this;
+	}
+
+
+	template<typename coordinate_type, size_t dimensions>
+	constexpr coordinate_type Vector<coordinate_type, dimensions>::operator[](const unsigned int _index) const
+	{
+		assert(_index < dimensions);
 		return coords[_index];
 	}
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline void Vector<coordinate_type, dimensions>::assign(const unsigned int _index, coordinate_type value)
+	constexpr coordinate_type& Vector<coordinate_type, dimensions>::operator[](const unsigned int _index)
 	{
-		if (_index >= coords.size()) {
-			std::cout << "Index out of bounds";
-		}
+		assert(_index < dimensions);
+		return coords[_index];
+	}
 
+
+	template<typename coordinate_type, size_t dimensions>
+	constexpr void Vector<coordinate_type, dimensions>::assign(const unsigned int _index, coordinate_type value)
+	{
+		assert(_index < dimensions);
 		coords[_index] = value;
 	}
 
 	template<typename coordinate_type, size_t dimensions>
-	inline float Vector<coordinate_type, dimensions>::magnitude() const
+	inline real_t<coordinate_type> Vector<coordinate_type, dimensions>::magnitude() const
 	{
-		float value = 0.0f;
-		for (int i = 0; i < dimensions; i++)
-			value += pow(coords[i], 2.0);
+		real_t<coordinate_type> value = 0;
+		for (size_t i = 0; i < dimensions; i++)
+			value += (double)coords[i] * coords[i];
 
 		return sqrt(value);
 	}
@@ -437,31 +520,62 @@ namespace jmk {
 
 
 	template<typename coordinate_type, size_t dimensions>
-	inline std::array<coordinate_type, dimensions> Vector<coordinate_type, dimensions>::data()
+	constexpr coordinate_type* Vector<coordinate_type, dimensions>::data()
 	{
-		return std::array<coordinate_type, dimensions>();
+		return coords.data();
 	}
 
 
 	template<typename coordinate_type, size_t dimensions>
-	float dotProduct(const Vector<coordinate_type, dimensions>& v1, const Vector<coordinate_type, dimensions>& v2)
+	constexpr const coordinate_type* Vector<coordinate_type, dimensions>::data() const
 	{
-		if (v1.coords.size() != v2.coords.size())
-			return FLT_MIN;
+		return coords.data();
+	}
 
-		float product = 0;
-		for (size_t i = 0; i < v1.coords.size(); i++)
-			product = product + v1[i] * v2[i];
+
+	// The result type is real_t, so float vectors accumulate in float, double vectors in double and
+	// integer vectors in double (their products may not fit the integer type)
+	template<typename coordinate_type, size_t dimensions>
+	constexpr real_t<coordinate_type> dotProduct(const Vector<coordinate_type, dimensions>& v1, const Vector<coordinate_type, dimensions>& v2)
+	{
+		real_t<coordinate_type> product = 0;
+		for (size_t i = 0; i < dimensions; i++)
+			product = product + (real_t<coordinate_type>)v1.coords[i] * v2.coords[i];
 		return product;
 	}
 
-	Vector3f crossProduct3D(Vector3f a, Vector3f b);
-	
-	float crossProduct2D(Vector2f a, Vector2f b);
+	template<typename coordinate_type>
+	inline Vector<real_t<coordinate_type>, DIM3> crossProduct3D(const Vector<coordinate_type, DIM3>& v1, const Vector<coordinate_type, DIM3>& v2)
+	{
+		typedef real_t<coordinate_type> real;
 
-	Vector2f prependicluar(Vector2f&);
+		real x_ = (real)v1[Y] * v2[Z] - (real)v2[Y] * v1[Z];
+		real y_ = -((real)v2[Z] * v1[X] - (real)v1[Z] * v2[X]);  // es lo mimso y_ = v1[Z] * v2[X] - v1[X] * v2[Z];
+		real z_ = (real)v1[X] * v2[Y] - (real)v2[X] * v1[Y];
 
-	float scalerTripleProduct(Vector3f a, Vector3f b, Vector3f c);
+		return Vector<real, DIM3>(x_, y_, z_);
+	}
+
+	template<typename coordinate_type>
+	inline real_t<coordinate_type> crossProduct2D(const Vector<coordinate_type, DIM2>& v1, const Vector<coordinate_type, DIM2>& v2)
+	{
+		return (real_t<coordinate_type>)v1[X] * v2[Y] - (real_t<coordinate_type>)v1[Y] * v2[X];
+	}
+
+	template<typename coordinate_type>
+	inline real_t<coordinate_type> scalerTripleProduct(const Vector<coordinate_type, DIM3>& v1, const Vector<coordinate_type, DIM3>& v2, const Vector<coordinate_type, DIM3>& v3)
+	{
+		auto bc_cross = crossProduct3D(v2, v3);
+
+		return dotProduct(Vector<real_t<coordinate_type>, DIM3>(v1[X], v1[Y], v1[Z]), bc_cross);
+	}
+
+	// SSE versions for the padded layout
+	float dotProduct(const Vector3fA& a, const Vector3fA& b);
+
+	Vector3fA crossProduct3D(const Vector3fA& a, const Vector3fA& b);
+
+	Vector2f prependicluar(Vector2f&);
 
 	bool orthogonal(Vector3f a, Vector3f b);
 
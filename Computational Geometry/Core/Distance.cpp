@@ -13,12 +13,13 @@ float jmk::distance(Line3dStd& line, Point3d& C)
 
 */
 
-float jmk::distance(Line& line, Point3d& C)
+template<class coord_type>
+jmk::real_t<coord_type> jmk::distance(LineT<coord_type>& line, Vector<coord_type, DIM3>& C)
 {
 	// TODO we can simple call distance frunction which takes three points here as well.
 	// But then the methodology of finding the distance is not visible to students. So keep this.
 	// Ignor the fact that we duplicate the similar implementation, which is not the best practise.
-	Vector3f AC = C - line.point();
+	auto AC = C - line.point();
 	auto t = dotProduct(line.direction(), AC);
 
 	auto xt = line.point() + line.direction() * t;
@@ -30,8 +31,14 @@ float jmk::distance(Line& line, Point3d& C)
 // Podria intentar de crear la otra formula de distancia para el punto y linea luego.
 
 
-float jmk::distance(Planef& p, Point3d& Q)
+template<class coord_type>
+jmk::real_t<coord_type> jmk::distance(Plane<coord_type>& p, Vector<coord_type, DIM3>& Q)
 {
 	auto result = dotProduct(p.getNormal(), Q) - p.getD();
 	return result;
 }
+
+template float jmk::distance<float>(Line&, Point3d&);
+template double jmk::distance<double>(Line3lf&, Point3lf&);
+template float jmk::distance<float>(Planef&, Point3d&);
+template double jmk::distance<double>(Planelf&, Point3lf&);
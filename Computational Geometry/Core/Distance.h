@@ -17,11 +17,14 @@ namespace jmk {
 	
 	//float distance(Point3d& A, Point3d& B, Point3d& C);
 
-	float distance(Line& line, Point3d& C);
+	// Instantiated for float and double coordinates
+	template<class coord_type>
+	real_t<coord_type> distance(LineT<coord_type>& line, Vector<coord_type, DIM3>& C);
 
 	//float distance(Line3d& line, Point3d& C);
 
-	float distance(Planef& p, Point3d& Q);
+	template<class coord_type>
+	real_t<coord_type> distance(Plane<coord_type>& p, Vector<coord_type, DIM3>& Q);
 
 	/*
 	float distance(Line2d& line, Point2d& C);
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Base/Vector.h"
+
+// Uniform grid over a set of segments. Every segment is stored in all the cells its bounding box
+// overlaps, so the segments that can intersect a query segment are found by visiting only the cells
+// of the query's bounding box. The ear clipping keeps the live polygon edges here, removing and
+// inserting them as ears are clipped, so a diagonal test does not have to look at the whole ring.
+// Points can be kept as zero length segments.
+
+namespace jmk {
+
+	template<class coord_type, class Handle>
+	class EdgeGrid
+	{
+	public:
+		// Segment from -> to. The handles identify the end points (vertex pointers or point indices),
+		// the coordinates are kept so a query does not have to look them up.
+		struct Entry
+		{
+			Handle from;
+			Handle to;
+			Vector<coord_type, DIM2> a;
+			Vector<coord_type, DIM2> b;
+		};
+
+	private:
+		std::vector<std::vector<Entry>> cells;
+		double min_x = 0.0, min_y = 0.0;
+		double inv_cell_x = 0.0, inv_cell_y = 0.0;
+		int columns = 1, rows = 1;
+
+		// Both mappings are monotone, so two segments that share a point always share a cell
+		int column(double x) const
+		{
+			return std::min(std::max((int)floor((x - min_x) * inv_cell_x), 0), columns - 1);
+		}
+
+		int row(double y) const
+		{
+			return std::min(std::max((int)floor((y - min_y) * inv_cell_y), 0), rows - 1);
+		}
+
+		template<class CellFunction>
+		bool forCells(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, CellFunction f) const
+		{
+			int c0 = column(std::min<double>(a[X], b[X])), c1 = column(std::max<double>(a[X], b[X]));
+			int r0 = row(std::min<double>(a[Y], b[Y])), r1 = row(std::max<double>(a[Y], b[Y]));
+
+			for (int r = r0; r <= r1; r++)
+				for (int c = c0; c <= c1; c++)
+					if (f(c, r))
+						return true;
+			return false;
+		}
+
+	public:
+		EdgeGrid() {}
+
+		// Clear the grid and size it to the bounding box [lo, hi], with about one cell per segment
+		void reset(const Vector<coord_type, DIM2>& lo, const Vector<coord_type, DIM2>& hi, size_t segment_count)
+		{
+			double width = (double)hi[X] - lo[X];
+			double height = (double)hi[Y] - lo[Y];
+			int resolution = std::max(1, (int)std::sqrt((double)segment_count));
+
+			columns = width > 0.0 ? resolution : 1;
+			rows = height > 0.0 ? resolution : 1;
+			min_x = lo[X];
+			min_y = lo[Y];
+			inv_cell_x = width > 0.0 ? columns / width : 0.0;
+			inv_cell_y = height > 0.0 ? rows / height : 0.0;
+
+			cells.assign((size_t)columns * rows, std::vector<Entry>());
+		}
+
+		void insert(Handle from, Handle to, const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b)
+		{
+			Entry entry{ from, to, a, b };
+			forCells(a, b, [&](int c, int r) { cells[(size_t)r * columns + c].push_back(entry); return false; });
+		}
+
+		// a and b must be the coordinates the segment was inserted with
+		void remove(Handle from, Handle to, const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b)
+		{
+			forCells(a, b, [&](int c, int r) {
+				auto& entries = cells[(size_t)r * columns + c];
+				for (size_t i = 0; i < entries.size(); i++)
+				{
+					if (entries[i].from == from && entries[i].to == to)
+					{
+						entries[i] = entries.back();
+						entries.pop_back();
+						break;
+					}
+				}
+				return false;
+			});
+		}
+
+		// Calls f for every stored segment whose bounding box overlaps the one of [a b], until f returns
+		// true. Returns whether it did. A segment spanning several cells is only reported from the cell
+		// holding the lower corner of the two boxes' overlap, so f sees it once.
+		template<class Function>
+		bool any(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, Function f) const
+		{
+			const coord_type min_qx = std::min(a[X], b[X]), max_qx = std::max(a[X], b[X]);
+			const coord_type min_qy = std::min(a[Y], b[Y]), max_qy = std::max(a[Y], b[Y]);
+
+			return forCells(a, b, [&](int c, int r) {
+				for (const Entry& entry : cells[(size_t)r * columns + c])
+				{
+					const coord_type min_ex = std::min(entry.a[X], entry.b[X]), min_ey = std::min(entry.a[Y], entry.b[Y]);
+					if (min_ex > max_qx || min_ey > max_qy
+						|| std::max(entry.a[X], entry.b[X]) < min_qx || std::max(entry.a[Y], entry.b[Y]) < min_qy)
+						continue;
+
+					if (column(std::max(min_ex, min_qx)) != c || row(std::max(min_ey, min_qy)) != r)
+						continue;
+
+					if (f(entry))
+						return true;
+				}
+				return false;
+			});
+		}
+
+		// Calls f for the points (zero length segments) stored in the cells the triangle a b c overlaps,
+		// until f returns true. Returns whether it did. Only the cells under the triangle are visited, row
+		// by row, so a long thin triangle costs its length in cells instead of its bounding box. Each row
+		// is widened by a cell on both sides against rounding, f still has to test the points itself.
+		template<class Function>
+		bool anyPoint(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c, Function f) const
+		{
+			const Vector<coord_type, DIM2>* corners[3] = { &a, &b, &c };
+			int r0 = row(std::min<double>({ a[Y], b[Y], c[Y] })), r1 = row(std::max<double>({ a[Y], b[Y], c[Y] }));
+
+			for (int r = r0; r <= r1; r++)
+			{
+				double band_lo = r == r0 ? -INFINITY : min_y + r / inv_cell_y;
+				double band_hi = r == r1 ? INFINITY : min_y + (r + 1) / inv_cell_y;
+
+				// x range of the triangle within the row: its corners in the row and where its sides
+				// cross the row's borders
+				double lo = INFINITY, hi = -INFINITY;
+				for (int i = 0; i < 3; i++)
+				{
+					const auto& p = *corners[i], & q = *corners[(i + 1) % 3];
+					if (p[Y] >= band_lo && p[Y] <= band_hi)
+					{
+						lo = std::min<double>(lo, p[X]);
+						hi = std::max<double>(hi, p[X]);
+					}
+					for (double y : { band_lo, band_hi })
+					{
+						if (std::isinf(y) || y <= std::min<double>(p[Y], q[Y]) || y >= std::max<double>(p[Y], q[Y]))
+							continue;
+						double x = p[X] + (y - p[Y]) * ((double)q[X] - p[X]) / ((double)q[Y] - p[Y]);
+						lo = std::min(lo, x);
+						hi = std::max(hi, x);
+					}
+				}
+				if (lo > hi)
+					continue;
+
+				int c0 = std::max(column(lo) - 1, 0), c1 = std::min(column(hi) + 1, columns - 1);
+				for (int col = c0; col <= c1; col++)
+					for (const Entry& entry : cells[(size_t)r * columns + col])
+						if (f(entry))
+							return true;
+			}
+			return false;
+		}
+	};
+}
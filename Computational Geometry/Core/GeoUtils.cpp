@@ -1,6 +1,7 @@
 #include "GeoUtils.h"
 
 #include "Base/Vector.h"
+#include "Predicates.h"
 #include "Primitives/Intersection.h"
 
 
@@ -37,22 +38,13 @@ double jmk::areaTriangle3d(const Point3d& a, const Point3d& b, const Point3d& c)
 
 
 
-int jmk::orientation2d(const Point2d & a, const Point2d & b, const Point2d & c)
+template<class coord_type>
+static int orientation2d_real(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c)
 {
-	// Compute the signed area of the triangle formed by points a, b, and c
-	auto area = areaTriangle2d(a, b, c);
-
-	// If area is very close to zero (within TOLERANCE), set it to zero
-	// This avoids issues with floating-point precision errors in collinear cases
-	if (area > 0 && area < TOLERANCE)
-		area = 0;
-
-	if (area < 0 && area > -TOLERANCE)
-		area = 0;
-
-	// Create vectors from point a to points b and c
-	Vector2f ab = b - a;
-	Vector2f ac = c - a;
+	// Compute the (twice) signed area of the triangle formed by points a, b, and c.
+	// orient2d escalates to exact arithmetic when needed, so its sign is always correct and
+	// collinear points give exactly zero. No tolerance is needed here.
+	auto area = orient2d(a, b, c);
 
 	// If area is positive, c is to the left of line a -> b (counterclockwise orientation)
 	if (area > 0.0)
@@ -63,12 +55,16 @@ int jmk::orientation2d(const Point2d & a, const Point2d & b, const Point2d & c)
 		return RIGHT;
 
 	// If area is zero, points are collinear; check relative positions
+	// Create vectors from point a to points b and c
+	auto ab = b - a;
+	auto ac = c - a;
+
 	// If c is behind a (in the opposite direction of vector ab), return BEHIND
 	if ((ab[X] * ac[X] < 0.0) || (ab[Y] * ac[Y] < 0.0))
 		return BEHIND;
 
-	// If c is beyond b, return BEYOND
-	if (ab.magnitude() < ac.magnitude())
+	// If c is beyond b, return BEYOND. Squared lengths are enough, no need for the sqrt.
+	if (dotProduct(ab, ab) < dotProduct(ac, ac))
 		return BEYOND;
 
 	// Special cases for collinear points:
@@ -85,6 +81,46 @@ int jmk::orientation2d(const Point2d & a, const Point2d & b, const Point2d & c)
 }
 
 
+int jmk::orientation2d(const Point2d& a, const Point2d& b, const Point2d& c)
+{
+	return orientation2d_real(a, b, c);
+}
+
+int jmk::orientation2d(const Point2lf& a, const Point2lf& b, const Point2lf& c)
+{
+	return orientation2d_real(a, b, c);
+}
+
+int jmk::orientation2d(const Point2i& a, const Point2i& b, const Point2i& c)
+{
+	int sign = orient2d(a, b, c);
+
+	if (sign > 0)
+		return LEFT;
+
+	if (sign < 0)
+		return RIGHT;
+
+	// Collinear. Coordinate differences can overflow int32, so only their signs are compared here.
+	auto sign_of = [](int64_t value) { return (value > 0) - (value < 0); };
+
+	if (sign_of((int64_t)b[X] - a[X]) * sign_of((int64_t)c[X] - a[X]) < 0
+		|| sign_of((int64_t)b[Y] - a[Y]) * sign_of((int64_t)c[Y] - a[Y]) < 0)
+		return BEHIND;
+
+	if (compareSquaredDistance(a, b, c) < 0)
+		return BEYOND;
+
+	if (a == c)
+		return ORIGIN;
+
+	if (b == c)
+		return DESTINATION;
+
+	return BETWEEN;
+}
+
+
 int jmk::orientation3d(const Point3d& a, const Point3d& b, const Point3d& c)
 {
 	float area = areaTriangle3d(a, b, c);
@@ -141,10 +177,8 @@ bool jmk::collinear(const Point3d& a, const Point3d& b, const Point3d& c)
 
 bool jmk::coplanar(const Point3d& a, const Point3d& b, const Point3d& c, const Point3d& d)
 {
-	auto AB = b - a;
-	auto AC = c - a;
-	auto AD = d - a;
-	return coplanar(AB, AC, AD);
+	// orient3d is exact in sign, so the four points are coplanar only when it is exactly zero
+	return orient3d(a, b, c, d) == 0.0;
 }
 
 bool jmk::coplanar(const Vector3f& a, const Vector3f& b, const Vector3f& c)
@@ -162,7 +196,18 @@ bool jmk::left(const Point3d& a, const Point3d& b, const Point3d& c)
 
 bool jmk::left(const Point2d& a, const Point2d& b, const Point2d& c)
 {
-	return orientation2d(a, b, c) == RELATIVE_POSITION::LEFT;
+	// Only the sign is needed, the collinear classification of orientation2d is skipped
+	return orient2d(a, b, c) > 0.0;
+}
+
+bool jmk::left(const Point2lf& a, const Point2lf& b, const Point2lf& c)
+{
+	return orient2d(a, b, c) > 0.0;
+}
+
+bool jmk::left(const Point2i& a, const Point2i& b, const Point2i& c)
+{
+	return orient2d(a, b, c) > 0;
 }
 
 /*
@@ -190,8 +235,30 @@ bool jmk::right(const Point3d& a, const Point3d& b, const Point3d& c)
 
 bool jmk::leftOrBeyond(const Point2d& a, const Point2d& b, const Point2d& c)
 {
-	int position = orientation2d(a, b, c);
-	return (position == RELATIVE_POSITION::LEFT || position == RELATIVE_POSITION::BEYOND);
+	// The full classification is only needed for collinear points
+	double area = orient2d(a, b, c);
+	if (area != 0.0)
+		return area > 0.0;
+
+	return orientation2d(a, b, c) == RELATIVE_POSITION::BEYOND;
+}
+
+bool jmk::leftOrBeyond(const Point2lf& a, const Point2lf& b, const Point2lf& c)
+{
+	double area = orient2d(a, b, c);
+	if (area != 0.0)
+		return area > 0.0;
+
+	return orientation2d(a, b, c) == RELATIVE_POSITION::BEYOND;
+}
+
+bool jmk::leftOrBeyond(const Point2i& a, const Point2i& b, const Point2i& c)
+{
+	int sign = orient2d(a, b, c);
+	if (sign != 0)
+		return sign > 0;
+
+	return orientation2d(a, b, c) == RELATIVE_POSITION::BEYOND;
 }
 
 bool jmk::leftOrBeyond(const Point3d& a, const Point3d& b, const Point3d& c)
@@ -206,56 +273,130 @@ bool jmk::leftOrBetween(const Point3d& a, const Point3d& b, const Point3d& c)
 	return (position == RELATIVE_POSITION::LEFT || position == RELATIVE_POSITION::BETWEEN);
 }
 
-static bool interiorCheck(const Vertex2dSimple* v1, const Vertex2dSimple* v2)
+// The diagonal test walks the ring through accessors, so the same code serves the VertexSimple linked
+// list and the index ring over a PointView. point(h) returns the coordinates of a ring element,
+// next(h) and prev(h) its neighbours.
+
+template<class Handle, class PointOf, class Next, class Prev>
+static bool interiorCheck(Handle v1, Handle v2, PointOf point, Next next, Prev prev)
 {
-	if (jmk::leftOrBeyond(v1->point, v1->next->point, v1->prev->point))
+	if (jmk::leftOrBeyond(point(v1), point(next(v1)), point(prev(v1))))
 	{
 		// v1 is convex vertex
-		return jmk::left(v1->point, v2->point, v1->prev->point)
-			&& jmk::left(v2->point, v1->point, v1->next->point);
+		return jmk::left(point(v1), point(v2), point(prev(v1)))
+			&& jmk::left(point(v2), point(v1), point(next(v1)));
 	}
 
 	// v1 is reflex vertex
-	return !(jmk::leftOrBeyond(v1->point, v2->point, v1->next->point) 
-		&& jmk::leftOrBeyond(v2->point, v1->point, v1->prev->point));
+	return !(jmk::leftOrBeyond(point(v1), point(v2), point(next(v1))) 
+		&& jmk::leftOrBeyond(point(v2), point(v1), point(prev(v1))));
 }
 
-bool jmk::isDiagonal(const Vertex2dSimple* v1, const Vertex2dSimple* v2, Polygon2dSimple* poly)
+template<class Handle, class PointOf, class Next, class Prev>
+static bool isDiagonalRing(Handle v1, Handle v2, Handle start, PointOf point, Next next, Prev prev)
 {
-	bool prospect = true;
-	std::vector<Vertex2dSimple*> vertices;
+	// Classify every vertex against the line v1 v2 in one batch. An edge whose end points are strictly
+	// on the same side can not intersect the segment, so the full Intersection test only runs for
+	// edges that cross or touch the line.
+	// The scratch buffers are reused between calls, so the walk does not allocate once they have grown.
+	static thread_local std::vector<Handle> ring;
+	static thread_local std::vector<std::decay_t<decltype(point(v1))>> points;
+	static thread_local std::vector<int8_t> sides;
+
+	ring.clear();
+	points.clear();
+	Handle current = start;
+	do
+	{
+		ring.push_back(current);
+		points.push_back(point(current));
+		current = next(current);
+	} while (current != start);
 
-	if (poly)
-		vertices = poly->getVertices();
-	else
+	orient2d_sign(point(v1), point(v2), points, sides);
+
+	const size_t size = ring.size();
+	for (size_t i = 0; i < size; i++)
 	{
-		auto vertex_ptr = v1->next;
-		vertices.push_back((Vertex2dSimple*)v1);
-		while (vertex_ptr != v1) 
-		{
-			vertices.push_back(vertex_ptr);
-			vertex_ptr = vertex_ptr->next;
-		}
+		size_t j = (i + 1) % size;
+		if (sides[i] != 0 && sides[i] == sides[j])
+			continue;
+
+		if (ring[i] != v1 && ring[j] != v1 && ring[i] != v2 && ring[j] != v2
+			&& jmk::Intersection(point(v1), point(v2), point(ring[i]), point(ring[j])))
+			return false;
 	}
 
-	Vertex2dSimple* current, * next;
-	current = vertices[0];
+	return interiorCheck(v1, v2, point, next, prev) && interiorCheck(v2, v1, point, next, prev);
+}
 
-	do
-	{
-		next = current->next;
-		if (current != v1 && next != v1 && current != v2 && next != v2
-			&& jmk::Intersection(v1->point, v2->point, current->point, next->point))
-		{
-			prospect = false;
-			break;
-		}
-		current = next;
-	}	while (current != vertices[0]);
-
-
-	return prospect && interiorCheck(v1, v2) && interiorCheck(v2, v1);
+template<class Handle, class Grid, class PointOf, class Next, class Prev>
+static bool isDiagonalGrid(Handle v1, Handle v2, const Grid& grid, PointOf point, Next next, Prev prev)
+{
+	// Only the edges stored in the cells covered by the segment v1 v2 can intersect it
+	const auto& p1 = point(v1);
+	const auto& p2 = point(v2);
+	bool crossed = grid.any(p1, p2, [&](const typename Grid::Entry& edge) {
+		return edge.from != v1 && edge.to != v1 && edge.from != v2 && edge.to != v2
+			&& jmk::Intersection(p1, p2, edge.a, edge.b);
+	});
+
+	return !crossed && interiorCheck(v1, v2, point, next, prev) && interiorCheck(v2, v1, point, next, prev);
 }
 
+template<class coord_type>
+bool jmk::isDiagonal(const VertexSimple<coord_type>* v1, const VertexSimple<coord_type>* v2, PolygonSimple<coord_type>* /*poly*/)
+{
+	typedef const VertexSimple<coord_type>* Handle;
+
+	// The ring is walked from v1, where it starts does not change the result. poly is not needed.
+	Handle start = v1;
+
+	return isDiagonalRing(v1, v2, start,
+		[](Handle v) -> const Vector<coord_type, DIM2>& { return v->point; },
+		[](Handle v) -> Handle { return v->next; },
+		[](Handle v) -> Handle { return v->prev; });
+}
 
+template<class coord_type>
+bool jmk::isDiagonal(const PointView<coord_type, DIM2>& points, const std::vector<uint32_t>& next, const std::vector<uint32_t>& prev, uint32_t v1, uint32_t v2)
+{
+	return isDiagonalRing(v1, v2, v1,
+		[&points](uint32_t v) -> const Vector<coord_type, DIM2>& { return points[v]; },
+		[&next](uint32_t v) { return next[v]; },
+		[&prev](uint32_t v) { return prev[v]; });
+}
+
+template<class coord_type>
+bool jmk::isDiagonal(const VertexSimple<coord_type>* v1, const VertexSimple<coord_type>* v2, const EdgeGrid<coord_type, const VertexSimple<coord_type>*>& grid)
+{
+	typedef const VertexSimple<coord_type>* Handle;
+
+	return isDiagonalGrid(v1, v2, grid,
+		[](Handle v) -> const Vector<coord_type, DIM2>& { return v->point; },
+		[](Handle v) -> Handle { return v->next; },
+		[](Handle v) -> Handle { return v->prev; });
+}
+
+template<class coord_type>
+bool jmk::isDiagonal(const PointView<coord_type, DIM2>& points, const std::vector<uint32_t>& next, const std::vector<uint32_t>& prev, uint32_t v1, uint32_t v2,
+	const EdgeGrid<coord_type, uint32_t>& grid)
+{
+	return isDiagonalGrid(v1, v2, grid,
+		[&points](uint32_t v) -> const Vector<coord_type, DIM2>& { return points[v]; },
+		[&next](uint32_t v) { return next[v]; },
+		[&prev](uint32_t v) { return prev[v]; });
+}
 
+template bool jmk::isDiagonal<float>(const Vertex2dSimple*, const Vertex2dSimple*, Polygon2dSimple*);
+template bool jmk::isDiagonal<int32_t>(const Vertex2iSimple*, const Vertex2iSimple*, Polygon2iSimple*);
+template bool jmk::isDiagonal<double>(const Vertex2lfSimple*, const Vertex2lfSimple*, Polygon2lfSimple*);
+template bool jmk::isDiagonal<float>(const PointView2f&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t);
+template bool jmk::isDiagonal<int32_t>(const PointView2i&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t);
+template bool jmk::isDiagonal<double>(const PointView2lf&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t);
+template bool jmk::isDiagonal<float>(const Vertex2dSimple*, const Vertex2dSimple*, const EdgeGrid<float, const Vertex2dSimple*>&);
+template bool jmk::isDiagonal<int32_t>(const Vertex2iSimple*, const Vertex2iSimple*, const EdgeGrid<int32_t, const Vertex2iSimple*>&);
+template bool jmk::isDiagonal<double>(const Vertex2lfSimple*, const Vertex2lfSimple*, const EdgeGrid<double, const Vertex2lfSimple*>&);
+template bool jmk::isDiagonal<float>(const PointView2f&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t, const EdgeGrid<float, uint32_t>&);
+template bool jmk::isDiagonal<int32_t>(const PointView2i&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t, const EdgeGrid<int32_t, uint32_t>&);
+template bool jmk::isDiagonal<double>(const PointView2lf&, const std::vector<uint32_t>&, const std::vector<uint32_t>&, uint32_t, uint32_t, const EdgeGrid<double, uint32_t>&);
\ No newline at end of file
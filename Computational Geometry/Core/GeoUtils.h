@@ -6,6 +6,7 @@
 #include "Primitives\Point.h"
 
 #include "Primitives\Polygon.h"
+#include "EdgeGrid.h"
 
 
 namespace  jmk
@@ -18,6 +19,11 @@ namespace  jmk
 
 	int orientation2d(const Point2d& a, const Point2d& b, const Point2d& c);
 
+	int orientation2d(const Point2lf& a, const Point2lf& b, const Point2lf& c);
+
+	// Exact version for integer points, no tolerance is involved
+	int orientation2d(const Point2i& a, const Point2i& b, const Point2i& c);
+
 	int orientation3d(const Point3d& a, const Point3d& b, const Point3d& c);
 
 	bool collinear(const Vector3f& a, const Vector3f& b);
@@ -34,6 +40,10 @@ namespace  jmk
 	// Predicate to determine whether the [Point c] is left to the segment [a b]
 	bool left(const Point2d& a, const Point2d& b, const Point2d& c);
 
+	bool left(const Point2lf& a, const Point2lf& b, const Point2lf& c);
+
+	bool left(const Point2i& a, const Point2i& b, const Point2i& c);
+
 	//bool left(const Line2dStd& l, const Point2d& p);
 
 	bool left(const Line2d& l, const Point2d& p);
@@ -44,11 +54,30 @@ namespace  jmk
 	// Predicate to determine whether the[Point c] is left to the segment[a b]
 	bool leftOrBeyond(const Point2d& a, const Point2d& b, const Point2d& c);
 
+	bool leftOrBeyond(const Point2lf& a, const Point2lf& b, const Point2lf& c);
+
+	bool leftOrBeyond(const Point2i& a, const Point2i& b, const Point2i& c);
+
 	// Predicate to determine whether the [Point c] is left to the segment [a b]
 	bool leftOrBeyond(const Point3d& a, const Point3d& b, const Point3d& c);
 
 	// Predicate to determine whether the [Point c] is left to or between the segment [a b]
 	bool leftOrBetween(const Point3d& a, const Point3d& b, const Point3d& c);
 
-	bool isDiagonal(const Vertex2dSimple* v1, const Vertex2dSimple* v2, Polygon2dSimple* poly = nullptr);
+	// Instantiated for float, double and int32_t coordinates
+	template<class coord_type>
+	bool isDiagonal(const VertexSimple<coord_type>* v1, const VertexSimple<coord_type>* v2, PolygonSimple<coord_type>* poly = nullptr);
+
+	// Same test for the ring of point indices described by next / prev over the given points
+	template<class coord_type>
+	bool isDiagonal(const PointView<coord_type, DIM2>& points, const std::vector<uint32_t>& next, const std::vector<uint32_t>& prev, uint32_t v1, uint32_t v2);
+
+	// Same tests, but the crossing edges are looked up in a grid holding the live edges of the ring
+	// instead of walking the whole ring. The grid must be kept in sync with the ring by the caller.
+	template<class coord_type>
+	bool isDiagonal(const VertexSimple<coord_type>* v1, const VertexSimple<coord_type>* v2, const EdgeGrid<coord_type, const VertexSimple<coord_type>*>& grid);
+
+	template<class coord_type>
+	bool isDiagonal(const PointView<coord_type, DIM2>& points, const std::vector<uint32_t>& next, const std::vector<uint32_t>& prev, uint32_t v1, uint32_t v2,
+		const EdgeGrid<coord_type, uint32_t>& grid);
 }
@@ -0,0 +1,815 @@
+#include "Predicates.h"
+#include "Base\Simd.h"
+
+#include <vector>
+#include <cstdint>
+
+using namespace jmk;
+
+// ---------------------------------------------------------------------------------------------
+// Floating point expansion arithmetic.
+// An expansion is a sum of doubles stored in increasing order of magnitude with no overlapping bits.
+// All the routines below are exact as long as the FPU rounds to nearest in double precision.
+// ---------------------------------------------------------------------------------------------
+
+static const double epsilon = 1.1102230246251565e-16;		// 2^-53
+static const double splitter = 134217729.0;					// 2^27 + 1
+
+static const double resulterrbound = (3.0 + 8.0 * epsilon) * epsilon;
+static const double ccwerrboundA = (3.0 + 16.0 * epsilon) * epsilon;
+static const double ccwerrboundB = (2.0 + 12.0 * epsilon) * epsilon;
+static const double ccwerrboundC = (9.0 + 64.0 * epsilon) * epsilon * epsilon;
+static const double o3derrboundA = (7.0 + 56.0 * epsilon) * epsilon;
+static const double iccerrboundA = (10.0 + 96.0 * epsilon) * epsilon;
+
+typedef std::vector<double> Expansion;
+
+// x + y = a + b exactly, requires |a| >= |b|
+static inline void fast_two_sum(double a, double b, double& x, double& y)
+{
+	x = a + b;
+	double bvirt = x - a;
+	y = b - bvirt;
+}
+
+// x + y = a + b exactly
+static inline void two_sum(double a, double b, double& x, double& y)
+{
+	x = a + b;
+	double bvirt = x - a;
+	double avirt = x - bvirt;
+	double bround = b - bvirt;
+	double around = a - avirt;
+	y = around + bround;
+}
+
+// Round off error of x = a - b
+static inline double two_diff_tail(double a, double b, double x)
+{
+	double bvirt = a - x;
+	double avirt = x + bvirt;
+	double bround = bvirt - b;
+	double around = a - avirt;
+	return around + bround;
+}
+
+// Split a in to two halves with 26 significant bits each, a = hi + lo
+static inline void split(double a, double& hi, double& lo)
+{
+	double c = splitter * a;
+	double abig = c - a;
+	hi = c - abig;
+	lo = a - hi;
+}
+
+// x + y = a * b exactly
+static inline void two_product(double a, double b, double& x, double& y)
+{
+	x = a * b;
+	double ahi, alo, bhi, blo;
+	split(a, ahi, alo);
+	split(b, bhi, blo);
+	double err1 = x - (ahi * bhi);
+	double err2 = err1 - (alo * bhi);
+	double err3 = err2 - (ahi * blo);
+	y = (alo * blo) - err3;
+}
+
+// h = e + f. Zero components are removed from the result.
+static Expansion expansion_sum(const Expansion& e, const Expansion& f)
+{
+	Expansion h;
+	h.reserve(e.size() + f.size());
+
+	size_t eindex = 0, findex = 0;
+	double Q, Qnew, hh;
+
+	auto take_next = [&]() {
+		// Pick the smaller magnitude component of the two inputs
+		if (findex >= f.size() || (eindex < e.size() && ((f[findex] > e[eindex]) == (f[findex] > -e[eindex]))))
+			return e[eindex++];
+		return f[findex++];
+	};
+
+	Q = take_next();
+	while (eindex < e.size() || findex < f.size())
+	{
+		two_sum(Q, take_next(), Qnew, hh);
+		Q = Qnew;
+		if (hh != 0.0)
+			h.push_back(hh);
+	}
+
+	if (Q != 0.0 || h.empty())
+		h.push_back(Q);
+	return h;
+}
+
+// h = e * b. Zero components are removed from the result.
+static Expansion scale_expansion(const Expansion& e, double b)
+{
+	Expansion h;
+	h.reserve(2 * e.size());
+
+	double Q, hh, product1, product0, sum;
+	two_product(e[0], b, Q, hh);
+	if (hh != 0.0)
+		h.push_back(hh);
+
+	for (size_t i = 1; i < e.size(); i++)
+	{
+		two_product(e[i], b, product1, product0);
+		two_sum(Q, product0, sum, hh);
+		if (hh != 0.0)
+			h.push_back(hh);
+		fast_two_sum(product1, sum, Q, hh);
+		if (hh != 0.0)
+			h.push_back(hh);
+	}
+
+	if (Q != 0.0 || h.empty())
+		h.push_back(Q);
+	return h;
+}
+
+// h = e * f
+static Expansion expansion_product(const Expansion& e, const Expansion& f)
+{
+	Expansion h = scale_expansion(e, f[0]);
+	for (size_t i = 1; i < f.size(); i++)
+		h = expansion_sum(h, scale_expansion(e, f[i]));
+	return h;
+}
+
+static Expansion negate(Expansion e)
+{
+	for (auto& component : e)
+		component = -component;
+	return e;
+}
+
+// Exact a - b as a two component expansion
+static Expansion exact_diff(double a, double b)
+{
+	double x = a - b;
+	double y = two_diff_tail(a, b, x);
+	if (y == 0.0)
+		return Expansion{ x };
+	return Expansion{ y, x };
+}
+
+// Exact a * d - b * c for expansions
+static Expansion exact_det2(const Expansion& a, const Expansion& b, const Expansion& c, const Expansion& d)
+{
+	return expansion_sum(expansion_product(a, d), negate(expansion_product(b, c)));
+}
+
+// Approximate value of an expansion
+static double estimate(const Expansion& e)
+{
+	double Q = 0.0;
+	for (double component : e)
+		Q += component;
+	return Q;
+}
+
+// ---------------------------------------------------------------------------------------------
+// orient2d
+// ---------------------------------------------------------------------------------------------
+
+// Adaptive stages for orient2d, only used when the fast filter could not decide the sign
+static double orient2dadapt(double ax, double ay, double bx, double by, double cx, double cy, double detsum)
+{
+	double acx = ax - cx;
+	double bcx = bx - cx;
+	double acy = ay - cy;
+	double bcy = by - cy;
+
+	double detleft, detlefttail, detright, detrighttail;
+	two_product(acx, bcy, detleft, detlefttail);
+	two_product(acy, bcx, detright, detrighttail);
+
+	// B = acx * bcy - acy * bcx, exactly for the rounded differences
+	Expansion B = expansion_sum(Expansion{ detlefttail, detleft }, Expansion{ -detrighttail, -detright });
+
+	double det = estimate(B);
+	double errbound = ccwerrboundB * detsum;
+	if ((det >= errbound) || (-det >= errbound))
+		return det;
+
+	double acxtail = two_diff_tail(ax, cx, acx);
+	double bcxtail = two_diff_tail(bx, cx, bcx);
+	double acytail = two_diff_tail(ay, cy, acy);
+	double bcytail = two_diff_tail(by, cy, bcy);
+
+	if ((acxtail == 0.0) && (acytail == 0.0) && (bcxtail == 0.0) && (bcytail == 0.0))
+		return det;
+
+	errbound = ccwerrboundC * detsum + resulterrbound * fabs(det);
+	det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+	if ((det >= errbound) || (-det >= errbound))
+		return det;
+
+	// Add the remaining tail products exactly
+	double s1, s0, t1, t0;
+	two_product(acxtail, bcy, s1, s0);
+	two_product(acytail, bcx, t1, t0);
+	Expansion C1 = expansion_sum(B, expansion_sum(Expansion{ s0, s1 }, Expansion{ -t0, -t1 }));
+
+	two_product(acx, bcytail, s1, s0);
+	two_product(acy, bcxtail, t1, t0);
+	Expansion C2 = expansion_sum(C1, expansion_sum(Expansion{ s0, s1 }, Expansion{ -t0, -t1 }));
+
+	two_product(acxtail, bcytail, s1, s0);
+	two_product(acytail, bcxtail, t1, t0);
+	Expansion D = expansion_sum(C2, expansion_sum(Expansion{ s0, s1 }, Expansion{ -t0, -t1 }));
+
+	return D.back();
+}
+
+template<class coord_type>
+static double orient2d_filtered(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c)
+{
+	double ax = a[X], ay = a[Y];
+	double bx = b[X], by = b[Y];
+	double cx = c[X], cy = c[Y];
+
+	double detleft = (ax - cx) * (by - cy);
+	double detright = (ay - cy) * (bx - cx);
+	double det = detleft - detright;
+
+	// Cheap filter. When both products have different signs, or one of them is zero, no cancellation
+	// can happen and the test below always passes.
+	double detsum = fabs(detleft) + fabs(detright);
+	double errbound = ccwerrboundA * detsum;
+	if ((det >= errbound) || (-det >= errbound))
+		return det;
+
+	return orient2dadapt(ax, ay, bx, by, cx, cy, detsum);
+}
+
+double jmk::orient2d(const Point2d& a, const Point2d& b, const Point2d& c)
+{
+	return orient2d_filtered(a, b, c);
+}
+
+double jmk::orient2d(const Point2lf& a, const Point2lf& b, const Point2lf& c)
+{
+	return orient2d_filtered(a, b, c);
+}
+
+// ---------------------------------------------------------------------------------------------
+// orient3d
+// ---------------------------------------------------------------------------------------------
+
+template<class coord_type>
+static double orient3dexact(const Vector<coord_type, DIM3>& a, const Vector<coord_type, DIM3>& b, const Vector<coord_type, DIM3>& c, const Vector<coord_type, DIM3>& d)
+{
+	Expansion adx = exact_diff(a[X], d[X]), ady = exact_diff(a[Y], d[Y]), adz = exact_diff(a[Z], d[Z]);
+	Expansion bdx = exact_diff(b[X], d[X]), bdy = exact_diff(b[Y], d[Y]), bdz = exact_diff(b[Z], d[Z]);
+	Expansion cdx = exact_diff(c[X], d[X]), cdy = exact_diff(c[Y], d[Y]), cdz = exact_diff(c[Z], d[Z]);
+
+	Expansion det = expansion_product(adz, exact_det2(bdx, bdy, cdx, cdy));
+	det = expansion_sum(det, expansion_product(bdz, exact_det2(cdx, cdy, adx, ady)));
+	det = expansion_sum(det, expansion_product(cdz, exact_det2(adx, ady, bdx, bdy)));
+
+	return det.back();
+}
+
+template<class coord_type>
+static double orient3d_filtered(const Vector<coord_type, DIM3>& a, const Vector<coord_type, DIM3>& b, const Vector<coord_type, DIM3>& c, const Vector<coord_type, DIM3>& d)
+{
+	double adx = (double)a[X] - d[X], ady = (double)a[Y] - d[Y], adz = (double)a[Z] - d[Z];
+	double bdx = (double)b[X] - d[X], bdy = (double)b[Y] - d[Y], bdz = (double)b[Z] - d[Z];
+	double cdx = (double)c[X] - d[X], cdy = (double)c[Y] - d[Y], cdz = (double)c[Z] - d[Z];
+
+	double bdxcdy = bdx * cdy;
+	double cdxbdy = cdx * bdy;
+
+	double cdxady = cdx * ady;
+	double adxcdy = adx * cdy;
+
+	double adxbdy = adx * bdy;
+	double bdxady = bdx * ady;
+
+	double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+
+	double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * fabs(adz)
+		+ (fabs(cdxady) + fabs(adxcdy)) * fabs(bdz)
+		+ (fabs(adxbdy) + fabs(bdxady)) * fabs(cdz);
+
+	double errbound = o3derrboundA * permanent;
+	if ((det > errbound) || (-det > errbound))
+		return det;
+
+	return orient3dexact(a, b, c, d);
+}
+
+double jmk::orient3d(const Point3d& a, const Point3d& b, const Point3d& c, const Point3d& d)
+{
+	return orient3d_filtered(a, b, c, d);
+}
+
+double jmk::orient3d(const Point3lf& a, const Point3lf& b, const Point3lf& c, const Point3lf& d)
+{
+	return orient3d_filtered(a, b, c, d);
+}
+
+// ---------------------------------------------------------------------------------------------
+// incircle
+// ---------------------------------------------------------------------------------------------
+
+template<class coord_type>
+static double incircleexact(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c, const Vector<coord_type, DIM2>& d)
+{
+	Expansion adx = exact_diff(a[X], d[X]), ady = exact_diff(a[Y], d[Y]);
+	Expansion bdx = exact_diff(b[X], d[X]), bdy = exact_diff(b[Y], d[Y]);
+	Expansion cdx = exact_diff(c[X], d[X]), cdy = exact_diff(c[Y], d[Y]);
+
+	Expansion alift = expansion_sum(expansion_product(adx, adx), expansion_product(ady, ady));
+	Expansion blift = expansion_sum(expansion_product(bdx, bdx), expansion_product(bdy, bdy));
+	Expansion clift = expansion_sum(expansion_product(cdx, cdx), expansion_product(cdy, cdy));
+
+	Expansion det = expansion_product(alift, exact_det2(bdx, bdy, cdx, cdy));
+	det = expansion_sum(det, expansion_product(blift, exact_det2(cdx, cdy, adx, ady)));
+	det = expansion_sum(det, expansion_product(clift, exact_det2(adx, ady, bdx, bdy)));
+
+	return det.back();
+}
+
+template<class coord_type>
+static double incircle_filtered(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c, const Vector<coord_type, DIM2>& d)
+{
+	double adx = (double)a[X] - d[X], ady = (double)a[Y] - d[Y];
+	double bdx = (double)b[X] - d[X], bdy = (double)b[Y] - d[Y];
+	double cdx = (double)c[X] - d[X], cdy = (double)c[Y] - d[Y];
+
+	double bdxcdy = bdx * cdy;
+	double cdxbdy = cdx * bdy;
+	double alift = adx * adx + ady * ady;
+
+	double cdxady = cdx * ady;
+	double adxcdy = adx * cdy;
+	double blift = bdx * bdx + bdy * bdy;
+
+	double adxbdy = adx * bdy;
+	double bdxady = bdx * ady;
+	double clift = cdx * cdx + cdy * cdy;
+
+	double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+	double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * alift
+		+ (fabs(cdxady) + fabs(adxcdy)) * blift
+		+ (fabs(adxbdy) + fabs(bdxady)) * clift;
+
+	double errbound = iccerrboundA * permanent;
+	if ((det > errbound) || (-det > errbound))
+		return det;
+
+	return incircleexact(a, b, c, d);
+}
+
+double jmk::incircle(const Point2d& a, const Point2d& b, const Point2d& c, const Point2d& d)
+{
+	return incircle_filtered(a, b, c, d);
+}
+
+double jmk::incircle(const Point2lf& a, const Point2lf& b, const Point2lf& c, const Point2lf& d)
+{
+	return incircle_filtered(a, b, c, d);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Exact integer predicates
+// ---------------------------------------------------------------------------------------------
+
+// Signed 128 bit integer, only the few operations needed by the predicates.
+struct Int128
+{
+	int64_t hi;
+	uint64_t lo;
+};
+
+// Full 64 x 64 -> 128 bit signed product
+static Int128 mul128(int64_t a, int64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+	__int128 r = (__int128)a * b;
+	return Int128{ (int64_t)(r >> 64), (uint64_t)r };
+#else
+	// Multiply the magnitudes in 32 bit limbs and fix the sign at the end
+	bool negative = (a < 0) != (b < 0);
+	uint64_t ua = a < 0 ? 0 - (uint64_t)a : (uint64_t)a;
+	uint64_t ub = b < 0 ? 0 - (uint64_t)b : (uint64_t)b;
+
+	uint64_t a_lo = ua & 0xffffffff, a_hi = ua >> 32;
+	uint64_t b_lo = ub & 0xffffffff, b_hi = ub >> 32;
+
+	uint64_t p0 = a_lo * b_lo;
+	uint64_t p1 = a_lo * b_hi;
+	uint64_t p2 = a_hi * b_lo;
+	uint64_t p3 = a_hi * b_hi;
+
+	uint64_t mid = (p0 >> 32) + (p1 & 0xffffffff) + (p2 & 0xffffffff);
+	uint64_t lo = (p0 & 0xffffffff) | (mid << 32);
+	uint64_t hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+
+	if (negative) {
+		lo = ~lo + 1;
+		hi = ~hi + (lo == 0 ? 1 : 0);
+	}
+	return Int128{ (int64_t)hi, lo };
+#endif
+}
+
+static Int128 add128(const Int128& a, const Int128& b)
+{
+	uint64_t lo = a.lo + b.lo;
+	int64_t hi = (int64_t)((uint64_t)a.hi + (uint64_t)b.hi + (lo < a.lo ? 1 : 0));
+	return Int128{ hi, lo };
+}
+
+// Sign of a - b
+static int compare128(const Int128& a, const Int128& b)
+{
+	if (a.hi != b.hi)
+		return a.hi < b.hi ? -1 : 1;
+	if (a.lo != b.lo)
+		return a.lo < b.lo ? -1 : 1;
+	return 0;
+}
+
+int jmk::orient2d(const Point2i& a, const Point2i& b, const Point2i& c)
+{
+	int64_t acx = (int64_t)a[X] - c[X];
+	int64_t bcx = (int64_t)b[X] - c[X];
+	int64_t acy = (int64_t)a[Y] - c[Y];
+	int64_t bcy = (int64_t)b[Y] - c[Y];
+
+	return compare128(mul128(acx, bcy), mul128(acy, bcx));
+}
+
+int jmk::compareSquaredDistance(const Point2i& a, const Point2i& b, const Point2i& c)
+{
+	int64_t abx = (int64_t)b[X] - a[X];
+	int64_t aby = (int64_t)b[Y] - a[Y];
+	int64_t acx = (int64_t)c[X] - a[X];
+	int64_t acy = (int64_t)c[Y] - a[Y];
+
+	// Each square is below 2^64, so the sums can not overflow 128 bits
+	Int128 ab = add128(mul128(abx, abx), mul128(aby, aby));
+	Int128 ac = add128(mul128(acx, acx), mul128(acy, acy));
+	return compare128(ab, ac);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Batch sign-only predicates
+// ---------------------------------------------------------------------------------------------
+
+// The SIMD kernels evaluate the same filter as the scalar predicates, in double precision over
+// 4 (AVX2) or 2 (SSE2) points at a time. Lanes whose result is not certain are redone with the
+// scalar predicate, which escalates to exact arithmetic. Coordinates are float, so the conversion
+// to double is exact.
+
+static inline int8_t sign_of(double value)
+{
+	return (int8_t)((value > 0.0) - (value < 0.0));
+}
+
+// Runs the orient2d filter for the points (cx, cy) of every lane. Bit k of certain is set when the
+// sign of lane k is known, in which case bit k of positive / negative gives that sign. a and b are
+// Point2d or Point2lf.
+#if defined(JMK_SIMD_AVX2)
+#define ORIENT2D_LANES 4
+
+template<class point_type>
+static inline void orient2d_lanes(const point_type& a, const point_type& b, __m256d cx, __m256d cy, int& certain, int& positive, int& negative)
+{
+	const __m256d sign_mask = _mm256_set1_pd(-0.0);
+	const __m256d zero = _mm256_setzero_pd();
+
+	__m256d detleft = _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(a[X]), cx), _mm256_sub_pd(_mm256_set1_pd(b[Y]), cy));
+	__m256d detright = _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(a[Y]), cy), _mm256_sub_pd(_mm256_set1_pd(b[X]), cx));
+	__m256d det = _mm256_sub_pd(detleft, detright);
+
+	__m256d detsum = _mm256_add_pd(_mm256_andnot_pd(sign_mask, detleft), _mm256_andnot_pd(sign_mask, detright));
+	__m256d errbound = _mm256_mul_pd(_mm256_set1_pd(ccwerrboundA), detsum);
+
+	certain = _mm256_movemask_pd(_mm256_or_pd(_mm256_cmp_pd(det, errbound, _CMP_GE_OQ),
+		_mm256_cmp_pd(_mm256_sub_pd(zero, det), errbound, _CMP_GE_OQ)));
+	positive = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_GT_OQ));
+	negative = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_LT_OQ));
+}
+#elif defined(JMK_SIMD_SSE2)
+#define ORIENT2D_LANES 2
+
+template<class point_type>
+static inline void orient2d_lanes(const point_type& a, const point_type& b, __m128d cx, __m128d cy, int& certain, int& positive, int& negative)
+{
+	const __m128d sign_mask = _mm_set1_pd(-0.0);
+	const __m128d zero = _mm_setzero_pd();
+
+	__m128d detleft = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(a[X]), cx), _mm_sub_pd(_mm_set1_pd(b[Y]), cy));
+	__m128d detright = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(a[Y]), cy), _mm_sub_pd(_mm_set1_pd(b[X]), cx));
+	__m128d det = _mm_sub_pd(detleft, detright);
+
+	__m128d detsum = _mm_add_pd(_mm_andnot_pd(sign_mask, detleft), _mm_andnot_pd(sign_mask, detright));
+	__m128d errbound = _mm_mul_pd(_mm_set1_pd(ccwerrboundA), detsum);
+
+	certain = _mm_movemask_pd(_mm_or_pd(_mm_cmpge_pd(det, errbound), _mm_cmpge_pd(_mm_sub_pd(zero, det), errbound)));
+	positive = _mm_movemask_pd(_mm_cmpgt_pd(det, zero));
+	negative = _mm_movemask_pd(_mm_cmplt_pd(det, zero));
+}
+#endif
+
+void jmk::orient2d_sign(const Point2d& a, const Point2d& b, const Point2d* points, size_t count, int8_t* out)
+{
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	// Point2d is exactly two packed floats, so the points can be loaded straight from the array
+	// and split in to x and y lanes.
+	const float* coords = reinterpret_cast<const float*>(points);
+	int certain, positive, negative;
+
+	for (; i + ORIENT2D_LANES <= count; i += ORIENT2D_LANES)
+	{
+#if defined(JMK_SIMD_AVX2)
+		__m256d p01 = _mm256_cvtps_pd(_mm_loadu_ps(coords + 2 * i));
+		__m256d p23 = _mm256_cvtps_pd(_mm_loadu_ps(coords + 2 * i + 4));
+		__m256d cx = _mm256_permute4x64_pd(_mm256_unpacklo_pd(p01, p23), _MM_SHUFFLE(3, 1, 2, 0));
+		__m256d cy = _mm256_permute4x64_pd(_mm256_unpackhi_pd(p01, p23), _MM_SHUFFLE(3, 1, 2, 0));
+#else
+		__m128 p01 = _mm_loadu_ps(coords + 2 * i);
+		__m128d p0 = _mm_cvtps_pd(p01);
+		__m128d p1 = _mm_cvtps_pd(_mm_movehl_ps(p01, p01));
+		__m128d cx = _mm_unpacklo_pd(p0, p1);
+		__m128d cy = _mm_unpackhi_pd(p0, p1);
+#endif
+		orient2d_lanes(a, b, cx, cy, certain, positive, negative);
+
+		for (int k = 0; k < ORIENT2D_LANES; k++)
+		{
+			if (certain & (1 << k))
+				out[i + k] = (int8_t)(((positive >> k) & 1) - ((negative >> k) & 1));
+			else
+				out[i + k] = sign_of(orient2d(a, b, points[i + k]));
+		}
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = sign_of(orient2d(a, b, points[i]));
+}
+
+void jmk::orient2d_sign(const Point2d& a, const Point2d& b, const std::vector<Point2d>& points, std::vector<int8_t>& out)
+{
+	out.resize(points.size());
+	orient2d_sign(a, b, points.data(), points.size(), out.data());
+}
+
+void jmk::orient2d_sign(const Point2d& a, const Point2d& b, const PointBuffer2f& points, std::vector<int8_t>& out)
+{
+	const size_t size = points.size();
+	out.resize(size);
+
+	const float* px = points.data(X), * py = points.data(Y);
+	int8_t* result = out.data();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	int certain, positive, negative;
+
+	for (; i + ORIENT2D_LANES <= size; i += ORIENT2D_LANES)
+	{
+#if defined(JMK_SIMD_AVX2)
+		__m256d cx = _mm256_cvtps_pd(_mm_load_ps(px + i));
+		__m256d cy = _mm256_cvtps_pd(_mm_load_ps(py + i));
+#else
+		__m128d cx = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(px + i))));
+		__m128d cy = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(py + i))));
+#endif
+		orient2d_lanes(a, b, cx, cy, certain, positive, negative);
+
+		for (int k = 0; k < ORIENT2D_LANES; k++)
+		{
+			if (certain & (1 << k))
+				result[i + k] = (int8_t)(((positive >> k) & 1) - ((negative >> k) & 1));
+			else
+				result[i + k] = sign_of(orient2d(a, b, Point2d(px[i + k], py[i + k])));
+		}
+	}
+#endif
+	for (; i < size; i++)
+		result[i] = sign_of(orient2d(a, b, Point2d(px[i], py[i])));
+}
+
+void jmk::orient2d_sign(const Point2i& a, const Point2i& b, const Point2i* points, size_t count, int8_t* out)
+{
+	for (size_t i = 0; i < count; i++)
+		out[i] = (int8_t)orient2d(a, b, points[i]);
+}
+
+void jmk::orient2d_sign(const Point2i& a, const Point2i& b, const std::vector<Point2i>& points, std::vector<int8_t>& out)
+{
+	out.resize(points.size());
+	orient2d_sign(a, b, points.data(), points.size(), out.data());
+}
+
+void jmk::orient2d_sign(const Point2lf& a, const Point2lf& b, const Point2lf* points, size_t count, int8_t* out)
+{
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	// Same as for Point2d, the coordinates are already double so they are only split in to x and y
+	static_assert(sizeof(Point2lf) == 2 * sizeof(double), "Point2lf must be two packed doubles");
+	const double* coords = reinterpret_cast<const double*>(points);
+	int certain, positive, negative;
+
+	for (; i + ORIENT2D_LANES <= count; i += ORIENT2D_LANES)
+	{
+#if defined(JMK_SIMD_AVX2)
+		__m256d p01 = _mm256_loadu_pd(coords + 2 * i);
+		__m256d p23 = _mm256_loadu_pd(coords + 2 * i + 4);
+		__m256d cx = _mm256_permute4x64_pd(_mm256_unpacklo_pd(p01, p23), _MM_SHUFFLE(3, 1, 2, 0));
+		__m256d cy = _mm256_permute4x64_pd(_mm256_unpackhi_pd(p01, p23), _MM_SHUFFLE(3, 1, 2, 0));
+#else
+		__m128d p0 = _mm_loadu_pd(coords + 2 * i);
+		__m128d p1 = _mm_loadu_pd(coords + 2 * i + 2);
+		__m128d cx = _mm_unpacklo_pd(p0, p1);
+		__m128d cy = _mm_unpackhi_pd(p0, p1);
+#endif
+		orient2d_lanes(a, b, cx, cy, certain, positive, negative);
+
+		for (int k = 0; k < ORIENT2D_LANES; k++)
+		{
+			if (certain & (1 << k))
+				out[i + k] = (int8_t)(((positive >> k) & 1) - ((negative >> k) & 1));
+			else
+				out[i + k] = sign_of(orient2d(a, b, points[i + k]));
+		}
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = sign_of(orient2d(a, b, points[i]));
+}
+
+void jmk::orient2d_sign(const Point2lf& a, const Point2lf& b, const std::vector<Point2lf>& points, std::vector<int8_t>& out)
+{
+	out.resize(points.size());
+	orient2d_sign(a, b, points.data(), points.size(), out.data());
+}
+
+// Runs the orient3d filter for the points (dx, dy, dz) of every lane, with the same output as orient2d_lanes
+#if defined(JMK_SIMD_AVX2)
+#define ORIENT3D_LANES 4
+
+static inline void orient3d_lanes(const Point3d& a, const Point3d& b, const Point3d& c, __m256d dx, __m256d dy, __m256d dz,
+	int& certain, int& positive, int& negative)
+{
+	const __m256d sign_mask = _mm256_set1_pd(-0.0);
+	const __m256d zero = _mm256_setzero_pd();
+
+	__m256d adx = _mm256_sub_pd(_mm256_set1_pd(a[X]), dx), ady = _mm256_sub_pd(_mm256_set1_pd(a[Y]), dy), adz = _mm256_sub_pd(_mm256_set1_pd(a[Z]), dz);
+	__m256d bdx = _mm256_sub_pd(_mm256_set1_pd(b[X]), dx), bdy = _mm256_sub_pd(_mm256_set1_pd(b[Y]), dy), bdz = _mm256_sub_pd(_mm256_set1_pd(b[Z]), dz);
+	__m256d cdx = _mm256_sub_pd(_mm256_set1_pd(c[X]), dx), cdy = _mm256_sub_pd(_mm256_set1_pd(c[Y]), dy), cdz = _mm256_sub_pd(_mm256_set1_pd(c[Z]), dz);
+
+	__m256d bdxcdy = _mm256_mul_pd(bdx, cdy), cdxbdy = _mm256_mul_pd(cdx, bdy);
+	__m256d cdxady = _mm256_mul_pd(cdx, ady), adxcdy = _mm256_mul_pd(adx, cdy);
+	__m256d adxbdy = _mm256_mul_pd(adx, bdy), bdxady = _mm256_mul_pd(bdx, ady);
+
+	__m256d det = _mm256_add_pd(_mm256_add_pd(
+		_mm256_mul_pd(adz, _mm256_sub_pd(bdxcdy, cdxbdy)),
+		_mm256_mul_pd(bdz, _mm256_sub_pd(cdxady, adxcdy))),
+		_mm256_mul_pd(cdz, _mm256_sub_pd(adxbdy, bdxady)));
+
+	__m256d permanent = _mm256_add_pd(_mm256_add_pd(
+		_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(sign_mask, bdxcdy), _mm256_andnot_pd(sign_mask, cdxbdy)), _mm256_andnot_pd(sign_mask, adz)),
+		_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(sign_mask, cdxady), _mm256_andnot_pd(sign_mask, adxcdy)), _mm256_andnot_pd(sign_mask, bdz))),
+		_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(sign_mask, adxbdy), _mm256_andnot_pd(sign_mask, bdxady)), _mm256_andnot_pd(sign_mask, cdz)));
+
+	__m256d errbound = _mm256_mul_pd(_mm256_set1_pd(o3derrboundA), permanent);
+	certain = _mm256_movemask_pd(_mm256_or_pd(_mm256_cmp_pd(det, errbound, _CMP_GT_OQ),
+		_mm256_cmp_pd(_mm256_sub_pd(zero, det), errbound, _CMP_GT_OQ)));
+	positive = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_GT_OQ));
+	negative = _mm256_movemask_pd(_mm256_cmp_pd(det, zero, _CMP_LT_OQ));
+}
+#elif defined(JMK_SIMD_SSE2)
+#define ORIENT3D_LANES 2
+
+static inline void orient3d_lanes(const Point3d& a, const Point3d& b, const Point3d& c, __m128d dx, __m128d dy, __m128d dz,
+	int& certain, int& positive, int& negative)
+{
+	const __m128d sign_mask = _mm_set1_pd(-0.0);
+	const __m128d zero = _mm_setzero_pd();
+
+	__m128d adx = _mm_sub_pd(_mm_set1_pd(a[X]), dx), ady = _mm_sub_pd(_mm_set1_pd(a[Y]), dy), adz = _mm_sub_pd(_mm_set1_pd(a[Z]), dz);
+	__m128d bdx = _mm_sub_pd(_mm_set1_pd(b[X]), dx), bdy = _mm_sub_pd(_mm_set1_pd(b[Y]), dy), bdz = _mm_sub_pd(_mm_set1_pd(b[Z]), dz);
+	__m128d cdx = _mm_sub_pd(_mm_set1_pd(c[X]), dx), cdy = _mm_sub_pd(_mm_set1_pd(c[Y]), dy), cdz = _mm_sub_pd(_mm_set1_pd(c[Z]), dz);
+
+	__m128d bdxcdy = _mm_mul_pd(bdx, cdy), cdxbdy = _mm_mul_pd(cdx, bdy);
+	__m128d cdxady = _mm_mul_pd(cdx, ady), adxcdy = _mm_mul_pd(adx, cdy);
+	__m128d adxbdy = _mm_mul_pd(adx, bdy), bdxady = _mm_mul_pd(bdx, ady);
+
+	__m128d det = _mm_add_pd(_mm_add_pd(
+		_mm_mul_pd(adz, _mm_sub_pd(bdxcdy, cdxbdy)),
+		_mm_mul_pd(bdz, _mm_sub_pd(cdxady, adxcdy))),
+		_mm_mul_pd(cdz, _mm_sub_pd(adxbdy, bdxady)));
+
+	__m128d permanent = _mm_add_pd(_mm_add_pd(
+		_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(sign_mask, bdxcdy), _mm_andnot_pd(sign_mask, cdxbdy)), _mm_andnot_pd(sign_mask, adz)),
+		_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(sign_mask, cdxady), _mm_andnot_pd(sign_mask, adxcdy)), _mm_andnot_pd(sign_mask, bdz))),
+		_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(sign_mask, adxbdy), _mm_andnot_pd(sign_mask, bdxady)), _mm_andnot_pd(sign_mask, cdz)));
+
+	__m128d errbound = _mm_mul_pd(_mm_set1_pd(o3derrboundA), permanent);
+	certain = _mm_movemask_pd(_mm_or_pd(_mm_cmpgt_pd(det, errbound), _mm_cmpgt_pd(_mm_sub_pd(zero, det), errbound)));
+	positive = _mm_movemask_pd(_mm_cmpgt_pd(det, zero));
+	negative = _mm_movemask_pd(_mm_cmplt_pd(det, zero));
+}
+#endif
+
+void jmk::orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const Point3d* points, size_t count, int8_t* out)
+{
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	// Point3d is exactly three packed floats. Lanes of four points are loaded as three vectors and
+	// shuffled in to x, y and z.
+	static_assert(sizeof(Point3d) == 3 * sizeof(float), "Point3d must be three packed floats");
+	const float* coords = reinterpret_cast<const float*>(points);
+	int certain, positive, negative;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 p0 = _mm_loadu_ps(coords + 3 * i);        // x0 y0 z0 x1
+		__m128 p1 = _mm_loadu_ps(coords + 3 * i + 4);    // y1 z1 x2 y2
+		__m128 p2 = _mm_loadu_ps(coords + 3 * i + 8);    // z2 x3 y3 z3
+		__m128 xy23 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(2, 1, 3, 2));
+		__m128 yz01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(1, 0, 2, 1));
+		__m128 x = _mm_shuffle_ps(p0, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128 z = _mm_shuffle_ps(yz01, p2, _MM_SHUFFLE(3, 0, 3, 1));
+
+#if defined(JMK_SIMD_AVX2)
+		orient3d_lanes(a, b, c, _mm256_cvtps_pd(x), _mm256_cvtps_pd(y), _mm256_cvtps_pd(z), certain, positive, negative);
+#else
+		int certain_high, positive_high, negative_high;
+		orient3d_lanes(a, b, c, _mm_cvtps_pd(x), _mm_cvtps_pd(y), _mm_cvtps_pd(z), certain, positive, negative);
+		orient3d_lanes(a, b, c, _mm_cvtps_pd(_mm_movehl_ps(x, x)), _mm_cvtps_pd(_mm_movehl_ps(y, y)), _mm_cvtps_pd(_mm_movehl_ps(z, z)),
+			certain_high, positive_high, negative_high);
+		certain |= certain_high << 2;
+		positive |= positive_high << 2;
+		negative |= negative_high << 2;
+#endif
+		for (int k = 0; k < 4; k++)
+		{
+			if (certain & (1 << k))
+				out[i + k] = (int8_t)(((positive >> k) & 1) - ((negative >> k) & 1));
+			else
+				out[i + k] = sign_of(orient3d(a, b, c, points[i + k]));
+		}
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = sign_of(orient3d(a, b, c, points[i]));
+}
+
+void jmk::orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const std::vector<Point3d>& points, std::vector<int8_t>& out)
+{
+	out.resize(points.size());
+	orient3d_sign(a, b, c, points.data(), points.size(), out.data());
+}
+
+void jmk::orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const PointBuffer3f& points, std::vector<int8_t>& out)
+{
+	const size_t size = points.size();
+	out.resize(size);
+
+	const float* px = points.data(X), * py = points.data(Y), * pz = points.data(Z);
+	int8_t* result = out.data();
+
+	size_t i = 0;
+#if defined(JMK_SIMD_AVX2) || defined(JMK_SIMD_SSE2)
+	int certain, positive, negative;
+
+	for (; i + ORIENT3D_LANES <= size; i += ORIENT3D_LANES)
+	{
+#if defined(JMK_SIMD_AVX2)
+		__m256d dx = _mm256_cvtps_pd(_mm_load_ps(px + i));
+		__m256d dy = _mm256_cvtps_pd(_mm_load_ps(py + i));
+		__m256d dz = _mm256_cvtps_pd(_mm_load_ps(pz + i));
+#else
+		__m128d dx = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(px + i))));
+		__m128d dy = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(py + i))));
+		__m128d dz = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)(pz + i))));
+#endif
+		orient3d_lanes(a, b, c, dx, dy, dz, certain, positive, negative);
+
+		for (int k = 0; k < ORIENT3D_LANES; k++)
+		{
+			if (certain & (1 << k))
+				result[i + k] = (int8_t)(((positive >> k) & 1) - ((negative >> k) & 1));
+			else
+				result[i + k] = sign_of(orient3d(a, b, c, Point3d(px[i + k], py[i + k], pz[i + k])));
+		}
+	}
+#endif
+	for (; i < size; i++)
+		result[i] = sign_of(orient3d(a, b, c, Point3d(px[i], py[i], pz[i])));
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Primitives\Point.h"
+#include "Base\PointBuffer.h"
+
+// Robust geometric predicates based on J. R. Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates".
+// Each predicate first evaluates the determinant in plain double arithmetic and only falls back
+// to exact expansion arithmetic when the result is smaller than the rounding error bound.
+// So the returned value may be approximate, but its sign is always correct.
+
+namespace jmk
+{
+	// Positive if c lies to the left of the directed line a -> b (a, b, c counter-clockwise),
+	// negative if it lies to the right and zero if the three points are collinear.
+	double orient2d(const Point2d& a, const Point2d& b, const Point2d& c);
+	double orient2d(const Point2lf& a, const Point2lf& b, const Point2lf& c);
+
+	// Positive if d lies below the plane through a, b, c (a, b, c counter-clockwise when viewed from above),
+	// negative if it lies above and zero if the four points are coplanar.
+	double orient3d(const Point3d& a, const Point3d& b, const Point3d& c, const Point3d& d);
+	double orient3d(const Point3lf& a, const Point3lf& b, const Point3lf& c, const Point3lf& d);
+
+	// Positive if d lies inside the circle through a, b, c (a, b, c must be counter-clockwise),
+	// negative if it lies outside and zero if the four points are cocircular.
+	double incircle(const Point2d& a, const Point2d& b, const Point2d& c, const Point2d& d);
+	double incircle(const Point2lf& a, const Point2lf& b, const Point2lf& c, const Point2lf& d);
+
+	// Integer versions. Differences are taken in 64 bit and products in 128 bit, so the results are
+	// exact for the whole int32 range and only the sign is returned (1, -1 or 0).
+
+	int orient2d(const Point2i& a, const Point2i& b, const Point2i& c);
+
+	// Compares |b - a|^2 against |c - a|^2. Returns -1 if b is closer to a, 1 if c is closer, 0 if equal.
+	int compareSquaredDistance(const Point2i& a, const Point2i& b, const Point2i& c);
+
+	// Batch sign-only versions. Every point is classified against the same segment [a b] or plane
+	// [a b c] and only the sign is written to out (1, -1 or 0, same meaning as above).
+	// The double precision filter runs over several points at once, only the points it can not decide
+	// go through the exact scalar predicate. That holds for every float and double overload, arrays of
+	// points and PointBuffer alike. The integer overloads are exact already and go point by point.
+	// The output must have room for count values.
+
+	void orient2d_sign(const Point2d& a, const Point2d& b, const Point2d* points, size_t count, int8_t* out);
+	void orient2d_sign(const Point2d& a, const Point2d& b, const std::vector<Point2d>& points, std::vector<int8_t>& out);
+	void orient2d_sign(const Point2d& a, const Point2d& b, const PointBuffer2f& points, std::vector<int8_t>& out);
+
+	void orient2d_sign(const Point2lf& a, const Point2lf& b, const Point2lf* points, size_t count, int8_t* out);
+	void orient2d_sign(const Point2lf& a, const Point2lf& b, const std::vector<Point2lf>& points, std::vector<int8_t>& out);
+
+	void orient2d_sign(const Point2i& a, const Point2i& b, const Point2i* points, size_t count, int8_t* out);
+	void orient2d_sign(const Point2i& a, const Point2i& b, const std::vector<Point2i>& points, std::vector<int8_t>& out);
+
+	void orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const Point3d* points, size_t count, int8_t* out);
+	void orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const std::vector<Point3d>& points, std::vector<int8_t>& out);
+	void orient3d_sign(const Point3d& a, const Point3d& b, const Point3d& c, const PointBuffer3f& points, std::vector<int8_t>& out);
+}
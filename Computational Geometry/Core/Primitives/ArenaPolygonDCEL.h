@@ -0,0 +1,771 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include "Point.h"
+#include "../Base/PointView.h"
+#include "../Predicates.h"
+#include "DCELRange.h"
+
+// Index based DCEL. It holds the same polygon as PolygonDCEL, but the vertices, half edges and faces
+// live in three contiguous arrays and refer to each other by 32 bit handles (their position in those
+// arrays) instead of pointers to separate heap blocks. The two halves of an edge are stored side by
+// side, so the twin of half edge h is h ^ 1 and is not stored at all. Every element is plain data,
+// releasing the whole structure is a handful of array deallocations whatever its size.
+//
+// The handle accessors (point, origin, next, ...) and the list / split functions have the same names
+// as in PolygonDCEL, so the partition and triangulation code is written once for both.
+//
+// Thread safety is the same as for PolygonDCEL: separate polygons share nothing and can be used on
+// different threads at the same time, one polygon must not be modified while another thread uses it.
+
+namespace jmk {
+
+	// Handle meaning "no element", e.g. the outer boundary of the unbounded face
+#define DCEL_NULL UINT32_MAX
+
+	// Number of holes a face stores itself, any further ones go to the polygon's hole pool
+#define DCEL_INLINE_HOLES 2
+
+	template<class type = float, size_t dim = DIM3>
+	class ArenaPolygonDCEL
+	{
+	public:
+		typedef type coordinate_type;
+		typedef Vector<type, dim> VectorNf;
+		typedef uint32_t VertexHandle;
+		typedef uint32_t EdgeHandle;
+		typedef uint32_t FaceHandle;
+
+		struct Vertex
+		{
+			VectorNf point;
+			EdgeHandle incident_edge = DCEL_NULL;
+			uint32_t index = 0;                      // Position in the points the polygon was built from
+		};
+
+		struct Edge
+		{
+			VertexHandle origin = DCEL_NULL;         // DCEL_NULL once the edge is removed
+			EdgeHandle next = DCEL_NULL;
+			EdgeHandle prev = DCEL_NULL;
+			FaceHandle incident_face = DCEL_NULL;
+		};
+
+		// Small buffer list of hole boundaries. Most faces have none, so only the first
+		// DCEL_INLINE_HOLES are kept in the face, the rest are linked through the polygon's hole pool.
+		struct HoleList
+		{
+			EdgeHandle local[DCEL_INLINE_HOLES] = {};
+			uint32_t count = 0;
+			uint32_t spill = DCEL_NULL;              // First link in the hole pool
+		};
+
+		struct Face
+		{
+			EdgeHandle outer = DCEL_NULL;            // DCEL_NULL for the unbounded face
+			HoleList inner;
+			uint32_t visit = 0;                      // Scratch mark used to find the face shared by two vertices
+			EdgeHandle visit_edge = DCEL_NULL;       // Edge the face was reached through in that search
+			bool removed = false;                    // The slot is free for reuse
+		};
+
+		static_assert(std::is_trivially_destructible<Vertex>::value && std::is_trivially_destructible<Edge>::value
+			&& std::is_trivially_destructible<Face>::value, "DCEL elements must be plain data");
+
+	private:
+		struct HoleLink
+		{
+			EdgeHandle edge;
+			uint32_t next;
+		};
+
+		std::vector<Vertex> vertices;
+		std::vector<Edge> edges;
+		std::vector<Face> faces;
+		std::vector<HoleLink> hole_pool;
+		std::vector<EdgeHandle> free_edges;      // First halves of removed edges, reused before growing
+		std::vector<FaceHandle> free_faces;
+		uint32_t visit_mark = 0;
+
+		EdgeHandle addEdge(VertexHandle _v1, VertexHandle _v2);
+		void eraseEdge(EdgeHandle e);
+		FaceHandle addFace();
+		void eraseFace(FaceHandle f);
+		uint32_t nextVisitMark();
+
+		// Take the edge and its twin out of the vertex stars and the face cycles
+		void unlinkEdge(EdgeHandle e);
+
+	public:
+		// Build the DCEL from the points of a simple counter-clockwise polygon. Half edge 2i runs from
+		// point i to point i + 1 inside the polygon and 2i + 1 is its twin, face 0 is the polygon and
+		// face 1 the unbounded face, which has the clockwise ring as its hole.
+		explicit ArenaPolygonDCEL(std::vector<VectorNf>&);
+		explicit ArenaPolygonDCEL(const PointView<type, dim>&);
+
+		// Handle accessors, same names as in PolygonDCEL
+		const VectorNf& point(VertexHandle v) const { return vertices[v].point; }
+		uint32_t index(VertexHandle v) const { return vertices[v].index; }
+		EdgeHandle incidentEdge(VertexHandle v) const { return vertices[v].incident_edge; }
+		VertexHandle origin(EdgeHandle e) const { return edges[e].origin; }
+		VertexHandle destination(EdgeHandle e) const { return edges[e ^ 1].origin; }
+		EdgeHandle twin(EdgeHandle e) const { return e ^ 1; }
+		EdgeHandle next(EdgeHandle e) const { return edges[e].next; }
+		EdgeHandle prev(EdgeHandle e) const { return edges[e].prev; }
+		FaceHandle incidentFace(EdgeHandle e) const { return edges[e].incident_face; }
+		EdgeHandle outer(FaceHandle f) const { return faces[f].outer; }
+		bool isBounded(FaceHandle f) const { return faces[f].outer != DCEL_NULL; }
+
+		// Holes of a face
+		void addHole(FaceHandle f, EdgeHandle e);
+		uint32_t holeCount(FaceHandle f) const { return faces[f].inner.count; }
+
+		template<class Function>
+		void forEachHole(FaceHandle f, Function function) const;
+
+		// Insert an edge between two vertices, splitting the face they share. The old face keeps the
+		// larger side.
+		bool split(VertexHandle _v1, VertexHandle _v2);
+
+		// Insert all the given diagonals at once (2D only), same rules as PolygonDCEL::splitMany.
+		// Returns the number of diagonals inserted.
+		size_t splitMany(const std::vector<std::pair<VertexHandle, VertexHandle>>& _diagonals);
+
+		// Remove the edge between two vertices, merging the smaller of its faces in to the larger one.
+		// Only edges between two bounded faces (diagonals) can be removed.
+		bool join(VertexHandle _v1, VertexHandle _v2);
+
+		// Remove all the given diagonals at once, same rules as PolygonDCEL::joinMany.
+		// Returns the number of edges removed.
+		size_t joinMany(const std::vector<EdgeHandle>& _edges);
+
+		// Release everything, in O(1) as the elements need no destruction
+		void clear();
+
+		std::vector<VertexHandle> getVertexList() const;
+		std::vector<FaceHandle> getFaceList() const;
+		std::vector<EdgeHandle> getEdgeList() const;
+
+		// Steps and filters behind the walks below
+		struct NextStep
+		{
+			const ArenaPolygonDCEL* dcel;
+			EdgeHandle operator()(EdgeHandle e) const { return dcel->edges[e].next; }
+		};
+
+		struct StarStep
+		{
+			const ArenaPolygonDCEL* dcel;
+			EdgeHandle operator()(EdgeHandle e) const { return dcel->edges[e ^ 1].next; }
+		};
+
+		struct AnyVertex
+		{
+			bool operator()(VertexHandle) const { return true; }
+		};
+
+		struct LiveEdge
+		{
+			const ArenaPolygonDCEL* dcel;
+			bool operator()(EdgeHandle e) const { return dcel->edges[e].origin != DCEL_NULL; }
+		};
+
+		struct LiveFace
+		{
+			const ArenaPolygonDCEL* dcel;
+			bool operator()(FaceHandle f) const { return !dcel->faces[f].removed; }
+		};
+
+		// One edge per hole of a face, same order as forEachHole
+		class HoleRange
+		{
+			const ArenaPolygonDCEL* dcel;
+			FaceHandle face;
+
+		public:
+			class iterator
+			{
+				const ArenaPolygonDCEL* dcel;
+				const HoleList* inner;
+				uint32_t position;          // Inline holes first, then the spilled ones through link
+				uint32_t link;
+
+				uint32_t inlineCount() const { return std::min<uint32_t>(inner->count, DCEL_INLINE_HOLES); }
+
+			public:
+				iterator(const ArenaPolygonDCEL* _dcel, const HoleList* _inner, uint32_t _position, uint32_t _link)
+					: dcel(_dcel), inner(_inner), position(_position), link(_link) {}
+
+				EdgeHandle operator*() const
+				{
+					return position < inlineCount() ? inner->local[position] : dcel->hole_pool[link].edge;
+				}
+
+				iterator& operator++()
+				{
+					if (position < inlineCount())
+						position++;
+					else
+						link = dcel->hole_pool[link].next;
+					return *this;
+				}
+
+				bool operator==(const iterator& _other) const { return position == _other.position && link == _other.link; }
+				bool operator!=(const iterator& _other) const { return !(*this == _other); }
+			};
+
+			HoleRange(const ArenaPolygonDCEL* _dcel, FaceHandle _face) : dcel(_dcel), face(_face) {}
+
+			iterator begin() const
+			{
+				const HoleList& inner = dcel->faces[face].inner;
+				return iterator(dcel, &inner, 0, inner.spill);
+			}
+
+			iterator end() const
+			{
+				const HoleList& inner = dcel->faces[face].inner;
+				return iterator(dcel, &inner, std::min<uint32_t>(inner.count, DCEL_INLINE_HOLES), DCEL_NULL);
+			}
+		};
+
+		// Allocation free walks for range for loops, same names and meaning as in PolygonDCEL
+		CirculatorRange<EdgeHandle, NextStep> faceBoundary(FaceHandle f) const
+		{
+			return CirculatorRange<EdgeHandle, NextStep>(faces[f].outer, { this }, faces[f].outer == DCEL_NULL);
+		}
+		CirculatorRange<EdgeHandle, NextStep> edgeCycle(EdgeHandle e) const { return CirculatorRange<EdgeHandle, NextStep>(e, { this }); }
+		CirculatorRange<EdgeHandle, StarStep> vertexStar(VertexHandle v) const
+		{
+			return CirculatorRange<EdgeHandle, StarStep>(vertices[v].incident_edge, { this }, vertices[v].incident_edge == DCEL_NULL);
+		}
+		HoleRange holes(FaceHandle f) const { return HoleRange(this, f); }
+		HandleRange<AnyVertex> vertexRange() const { return HandleRange<AnyVertex>((uint32_t)vertices.size(), {}); }
+		HandleRange<LiveEdge> edgeRange() const { return HandleRange<LiveEdge>((uint32_t)edges.size(), { this }); }
+		HandleRange<LiveFace> faceRange() const { return HandleRange<LiveFace>((uint32_t)faces.size(), { this }); }
+
+		// Get a vertex based on its coordinates, DCEL_NULL if there is none
+		VertexHandle getVertex(const VectorNf&) const;
+
+		// Find edges leaving _v1 and _v2 on a bounded face they share, DCEL_NULL if there is none
+		void getEdgesWithSamefaceAndGivenOrigins(VertexHandle _v1, VertexHandle _v2,
+			EdgeHandle* edge_leaving_v1, EdgeHandle* edge_leaving_v2);
+
+		size_t vertexCount() const { return vertices.size(); }
+		size_t edgeCount() const { return edges.size() - 2 * free_edges.size(); }
+
+		// Bytes held by the arrays
+		size_t memoryUsage() const
+		{
+			return vertices.capacity() * sizeof(Vertex) + edges.capacity() * sizeof(Edge) + faces.capacity() * sizeof(Face)
+				+ hole_pool.capacity() * sizeof(HoleLink) + (free_edges.capacity() + free_faces.capacity()) * sizeof(uint32_t);
+		}
+	};
+
+	typedef ArenaPolygonDCEL<float, 2U>	ArenaPolygon2d;
+	typedef ArenaPolygonDCEL<int32_t, 2U>	ArenaPolygon2i;
+	typedef ArenaPolygonDCEL<double, 2U>	ArenaPolygon2lf;
+
+	template<class type, size_t dim>
+	inline ArenaPolygonDCEL<type, dim>::ArenaPolygonDCEL(std::vector<VectorNf>& _points) : ArenaPolygonDCEL(PointView<type, dim>(_points)) {}
+
+	template<class type, size_t dim>
+	inline ArenaPolygonDCEL<type, dim>::ArenaPolygonDCEL(const PointView<type, dim>& _points)
+	{
+		const uint32_t size = (uint32_t)_points.size();
+		// A polygon must have at least 3 vertices
+		if (size < 3)
+			return;
+
+		vertices.resize(size);
+		edges.resize(2 * size);
+		for (uint32_t i = 0; i < size; i++)
+		{
+			const uint32_t following = i + 1 == size ? 0 : i + 1;
+			const uint32_t preceding = i == 0 ? size - 1 : i - 1;
+
+			vertices[i].point = _points[i];
+			vertices[i].index = i;
+			vertices[i].incident_edge = 2 * i;
+
+			// Counter-clockwise half edge i -> i + 1 and its clockwise twin i + 1 -> i
+			edges[2 * i] = { i, 2 * following, 2 * preceding, 0 };
+			edges[2 * i + 1] = { following, 2 * preceding + 1, 2 * following + 1, 1 };
+		}
+
+		FaceHandle inside = addFace();
+		FaceHandle outside = addFace();
+		faces[inside].outer = 0;
+		addHole(outside, 1);
+	}
+
+	// New edge _v1 -> _v2, not linked yet. Returns the half leaving _v1, the other half is its twin.
+	template<class type, size_t dim>
+	inline typename ArenaPolygonDCEL<type, dim>::EdgeHandle ArenaPolygonDCEL<type, dim>::addEdge(VertexHandle _v1, VertexHandle _v2)
+	{
+		EdgeHandle e;
+		if (free_edges.empty())
+		{
+			e = (EdgeHandle)edges.size();
+			edges.resize(edges.size() + 2);
+		}
+		else
+		{
+			e = free_edges.back();
+			free_edges.pop_back();
+		}
+		edges[e] = { _v1, DCEL_NULL, DCEL_NULL, DCEL_NULL };
+		edges[e ^ 1] = { _v2, DCEL_NULL, DCEL_NULL, DCEL_NULL };
+		return e;
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::eraseEdge(EdgeHandle e)
+	{
+		e &= ~1u;
+		edges[e].origin = DCEL_NULL;
+		edges[e + 1].origin = DCEL_NULL;
+		free_edges.push_back(e);
+	}
+
+	template<class type, size_t dim>
+	inline typename ArenaPolygonDCEL<type, dim>::FaceHandle ArenaPolygonDCEL<type, dim>::addFace()
+	{
+		if (free_faces.empty())
+		{
+			faces.emplace_back();
+			return (FaceHandle)faces.size() - 1;
+		}
+
+		FaceHandle f = free_faces.back();
+		free_faces.pop_back();
+		faces[f] = Face();
+		return f;
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::eraseFace(FaceHandle f)
+	{
+		faces[f].removed = true;
+		free_faces.push_back(f);
+	}
+
+	// Fresh even mark, the odd one after it is free to use too
+	template<class type, size_t dim>
+	inline uint32_t ArenaPolygonDCEL<type, dim>::nextVisitMark()
+	{
+		if (visit_mark >= UINT32_MAX - 2)
+		{
+			for (auto& face : faces)
+				face.visit = 0;
+			visit_mark = 0;
+		}
+		visit_mark += 2;
+		return visit_mark;
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::addHole(FaceHandle f, EdgeHandle e)
+	{
+		HoleList& inner = faces[f].inner;
+		if (inner.count < DCEL_INLINE_HOLES)
+			inner.local[inner.count] = e;
+		else
+		{
+			hole_pool.push_back({ e, inner.spill });
+			inner.spill = (uint32_t)hole_pool.size() - 1;
+		}
+		inner.count++;
+	}
+
+	// Calls function(edge) for one edge of every hole of the face. The inline holes come first in the
+	// order they were added, the spilled ones follow, latest first.
+	template<class type, size_t dim>
+	template<class Function>
+	inline void ArenaPolygonDCEL<type, dim>::forEachHole(FaceHandle f, Function function) const
+	{
+		const HoleList& inner = faces[f].inner;
+		for (uint32_t i = 0; i < inner.count && i < DCEL_INLINE_HOLES; i++)
+			function(inner.local[i]);
+		for (uint32_t link = inner.spill; link != DCEL_NULL; link = hole_pool[link].next)
+			function(hole_pool[link].edge);
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::getEdgesWithSamefaceAndGivenOrigins(VertexHandle _v1, VertexHandle _v2,
+		EdgeHandle* edge_leaving_v1, EdgeHandle* edge_leaving_v2)
+	{
+		*edge_leaving_v1 = DCEL_NULL;
+		*edge_leaving_v2 = DCEL_NULL;
+
+		// Interleaved walk of both vertex stars, see PolygonDCEL::getEdgesWithSamefaceAndGivenOrigins
+		const uint32_t mark_v1 = nextVisitMark(), mark_v2 = mark_v1 + 1;
+
+		EdgeHandle v1_edge = vertices[_v1].incident_edge, v2_edge = vertices[_v2].incident_edge;
+		bool v1_done = false, v2_done = false;
+		while (!v1_done || !v2_done)
+		{
+			if (!v1_done)
+			{
+				Face& face = faces[edges[v1_edge].incident_face];
+				if (face.outer != DCEL_NULL)
+				{
+					if (face.visit == mark_v2)
+					{
+						*edge_leaving_v1 = v1_edge;
+						*edge_leaving_v2 = face.visit_edge;
+						return;
+					}
+					face.visit = mark_v1;
+					face.visit_edge = v1_edge;
+				}
+				v1_edge = edges[v1_edge ^ 1].next;
+				v1_done = v1_edge == vertices[_v1].incident_edge;
+			}
+
+			if (!v2_done)
+			{
+				Face& face = faces[edges[v2_edge].incident_face];
+				if (face.outer != DCEL_NULL)
+				{
+					if (face.visit == mark_v1)
+					{
+						*edge_leaving_v1 = face.visit_edge;
+						*edge_leaving_v2 = v2_edge;
+						return;
+					}
+					face.visit = mark_v2;
+					face.visit_edge = v2_edge;
+				}
+				v2_edge = edges[v2_edge ^ 1].next;
+				v2_done = v2_edge == vertices[_v2].incident_edge;
+			}
+		}
+	}
+
+	template<class type, size_t dim>
+	inline bool ArenaPolygonDCEL<type, dim>::split(VertexHandle _v1, VertexHandle _v2)
+	{
+		EdgeHandle edge_oriV1, edge_oriV2;
+		getEdgesWithSamefaceAndGivenOrigins(_v1, _v2, &edge_oriV1, &edge_oriV2);
+		if (edge_oriV1 == DCEL_NULL || edge_oriV2 == DCEL_NULL)
+			return false;
+
+		// Already adjacent on that face
+		if (edges[edges[edge_oriV1].next].origin == _v2 || edges[edges[edge_oriV1].prev].origin == _v2)
+			return false;
+
+		// half_edge1 runs _v1 -> _v2, half_edge2 runs back
+		const EdgeHandle half_edge1 = addEdge(_v1, _v2), half_edge2 = half_edge1 ^ 1;
+		edges[half_edge1].next = edge_oriV2;
+		edges[half_edge1].prev = edges[edge_oriV1].prev;
+		edges[half_edge2].next = edge_oriV1;
+		edges[half_edge2].prev = edges[edge_oriV2].prev;
+
+		edges[edges[half_edge1].next].prev = half_edge1;
+		edges[edges[half_edge2].next].prev = half_edge2;
+		edges[edges[half_edge1].prev].next = half_edge1;
+		edges[edges[half_edge2].prev].next = half_edge2;
+
+		// The old face keeps the longer side, only the shorter one is relabelled
+		const FaceHandle previous_face = edges[edge_oriV1].incident_face;
+		EdgeHandle walk1 = edges[half_edge1].next, walk2 = edges[half_edge2].next;
+		while (walk1 != half_edge1 && walk2 != half_edge2)
+		{
+			walk1 = edges[walk1].next;
+			walk2 = edges[walk2].next;
+		}
+		const EdgeHandle moved_edge = walk1 == half_edge1 ? half_edge1 : half_edge2;
+		const EdgeHandle kept_edge = moved_edge ^ 1;
+
+		faces[previous_face].outer = kept_edge;
+		edges[kept_edge].incident_face = previous_face;
+
+		const FaceHandle new_face = addFace();
+		faces[new_face].outer = moved_edge;
+		EdgeHandle edge = moved_edge;
+		do {
+			edges[edge].incident_face = new_face;
+			edge = edges[edge].next;
+		} while (edge != moved_edge);
+
+		return true;
+	}
+
+	template<class type, size_t dim>
+	inline size_t ArenaPolygonDCEL<type, dim>::splitMany(const std::vector<std::pair<VertexHandle, VertexHandle>>& _diagonals)
+	{
+		// Drop repeated pairs, in either direction
+		std::vector<std::pair<VertexHandle, VertexHandle>> diagonals;
+		diagonals.reserve(_diagonals.size());
+		for (auto& d : _diagonals)
+			if (d.first != d.second)
+				diagonals.push_back(std::minmax(d.first, d.second));
+		std::sort(diagonals.begin(), diagonals.end());
+		diagonals.erase(std::unique(diagonals.begin(), diagonals.end()), diagonals.end());
+
+		auto connected = [this](VertexHandle a, VertexHandle b) {
+			EdgeHandle edge = vertices[a].incident_edge;
+			do {
+				if (edges[edge ^ 1].origin == b)
+					return true;
+				edge = edges[edge ^ 1].next;
+			} while (edge != vertices[a].incident_edge);
+			return false;
+		};
+
+		// Create the half edges, keyed by their origin. They have no face yet.
+		std::vector<std::pair<VertexHandle, EdgeHandle>> new_edges;
+		new_edges.reserve(2 * diagonals.size());
+		for (auto& d : diagonals)
+		{
+			if (connected(d.first, d.second))
+				continue;
+
+			const EdgeHandle half_edge1 = addEdge(d.first, d.second);
+			new_edges.push_back({ d.first, half_edge1 });
+			new_edges.push_back({ d.second, half_edge1 ^ 1 });
+		}
+		std::sort(new_edges.begin(), new_edges.end());
+
+		// Counter-clockwise order of the outgoing edges around a vertex, starting from the +X direction
+		auto upper_half = [](const VectorNf& origin, const VectorNf& p) {
+			return p[Y] > origin[Y] || (p[Y] == origin[Y] && p[X] > origin[X]);
+		};
+
+		// Link the edges around every touched vertex, same as PolygonDCEL::splitMany
+		std::vector<EdgeHandle> around;
+		std::vector<FaceHandle> old_faces;
+		for (size_t first = 0; first < new_edges.size(); )
+		{
+			const VertexHandle vertex = new_edges[first].first;
+			const VectorNf& origin = vertices[vertex].point;
+
+			around.clear();
+			EdgeHandle edge = vertices[vertex].incident_edge;
+			do {
+				around.push_back(edge);
+				edge = edges[edge ^ 1].next;
+			} while (edge != vertices[vertex].incident_edge);
+
+			size_t last = first;
+			for (; last < new_edges.size() && new_edges[last].first == vertex; last++)
+				around.push_back(new_edges[last].second);
+
+			std::sort(around.begin(), around.end(), [&](EdgeHandle a, EdgeHandle b) {
+				const VectorNf& pa = vertices[edges[a ^ 1].origin].point;
+				const VectorNf& pb = vertices[edges[b ^ 1].origin].point;
+				bool upper_a = upper_half(origin, pa), upper_b = upper_half(origin, pb);
+				if (upper_a != upper_b)
+					return upper_a;
+				return orient2d(origin, pa, pb) > 0;
+			});
+
+			const size_t count = around.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				EdgeHandle current = around[i];
+				EdgeHandle clockwise = around[(i + count - 1) % count];
+				edges[current ^ 1].next = clockwise;
+				edges[clockwise].prev = current ^ 1;
+
+				if (edges[current].incident_face == DCEL_NULL && edges[clockwise].incident_face != DCEL_NULL)
+					old_faces.push_back(edges[clockwise].incident_face);
+			}
+
+			first = last;
+		}
+
+		// The split faces are released first, so the new ones take their slots
+		std::sort(old_faces.begin(), old_faces.end());
+		old_faces.erase(std::unique(old_faces.begin(), old_faces.end()), old_faces.end());
+		for (FaceHandle f : old_faces)
+			eraseFace(f);
+
+		for (auto& new_edge : new_edges)
+		{
+			const EdgeHandle start = new_edge.second;
+			if (edges[start].incident_face != DCEL_NULL)
+				continue;
+
+			const FaceHandle face = addFace();
+			faces[face].outer = start;
+			EdgeHandle edge = start;
+			do {
+				edges[edge].incident_face = face;
+				edge = edges[edge].next;
+			} while (edge != start);
+		}
+
+		return new_edges.size() / 2;
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::unlinkEdge(EdgeHandle e)
+	{
+		const EdgeHandle t = e ^ 1;
+		const EdgeHandle e_prev = edges[e].prev, e_next = edges[e].next;
+		const EdgeHandle t_prev = edges[t].prev, t_next = edges[t].next;
+
+		edges[e_prev].next = t_next;
+		edges[t_next].prev = e_prev;
+		edges[t_prev].next = e_next;
+		edges[e_next].prev = t_prev;
+
+		if (vertices[edges[e].origin].incident_edge == e)
+			vertices[edges[e].origin].incident_edge = t_next;
+		if (vertices[edges[t].origin].incident_edge == t)
+			vertices[edges[t].origin].incident_edge = e_next;
+	}
+
+	template<class type, size_t dim>
+	inline bool ArenaPolygonDCEL<type, dim>::join(VertexHandle _v1, VertexHandle _v2)
+	{
+		// Find the edge _v1 -> _v2 in the star of _v1
+		EdgeHandle edge = vertices[_v1].incident_edge;
+		while (edges[edge ^ 1].origin != _v2)
+		{
+			edge = edges[edge ^ 1].next;
+			if (edge == vertices[_v1].incident_edge)
+				return false;
+		}
+
+		const FaceHandle face1 = edges[edge].incident_face, face2 = edges[edge ^ 1].incident_face;
+		if (face1 == face2 || faces[face1].outer == DCEL_NULL || faces[face2].outer == DCEL_NULL)
+			return false;
+
+		// Same as PolygonDCEL::join, only the smaller face is relabelled
+		EdgeHandle walk1 = edges[edge].next, walk2 = edges[edge ^ 1].next;
+		while (walk1 != edge && walk2 != (edge ^ 1))
+		{
+			walk1 = edges[walk1].next;
+			walk2 = edges[walk2].next;
+		}
+		const EdgeHandle dropped_edge = walk1 == edge ? edge : edge ^ 1;
+		const EdgeHandle kept_edge = dropped_edge ^ 1;
+		const FaceHandle kept_face = edges[kept_edge].incident_face;
+		const FaceHandle dropped_face = edges[dropped_edge].incident_face;
+
+		for (EdgeHandle e = edges[dropped_edge].next; e != dropped_edge; e = edges[e].next)
+			edges[e].incident_face = kept_face;
+		if (faces[kept_face].outer == kept_edge)
+			faces[kept_face].outer = edges[kept_edge].next;
+
+		unlinkEdge(edge);
+		eraseEdge(edge);
+		eraseFace(dropped_face);
+		return true;
+	}
+
+	template<class type, size_t dim>
+	inline size_t ArenaPolygonDCEL<type, dim>::joinMany(const std::vector<EdgeHandle>& _edges)
+	{
+		// Keep the first half of every diagonal, see PolygonDCEL::joinMany for the steps
+		std::vector<EdgeHandle> removed;
+		removed.reserve(_edges.size());
+		for (EdgeHandle e : _edges)
+			if (edges[e].origin != DCEL_NULL && isBounded(edges[e].incident_face) && isBounded(edges[e ^ 1].incident_face))
+				removed.push_back(e & ~1u);
+		std::sort(removed.begin(), removed.end());
+		removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+		std::vector<FaceHandle> touched;
+		touched.reserve(2 * removed.size());
+		for (EdgeHandle e : removed)
+		{
+			touched.push_back(edges[e].incident_face);
+			touched.push_back(edges[e ^ 1].incident_face);
+			edges[e].incident_face = DCEL_NULL;
+			edges[e ^ 1].incident_face = DCEL_NULL;
+		}
+
+		std::vector<EdgeHandle> starts;
+		starts.reserve(2 * removed.size());
+		for (EdgeHandle e : removed)
+		{
+			starts.push_back(edges[e].prev);
+			starts.push_back(edges[e ^ 1].prev);
+			unlinkEdge(e);
+		}
+
+		const uint32_t kept = nextVisitMark();
+		for (EdgeHandle start : starts)
+		{
+			const FaceHandle face = edges[start].incident_face;
+			if (face == DCEL_NULL || faces[face].visit == kept)
+				continue;
+
+			faces[face].visit = kept;
+			faces[face].outer = start;
+			for (EdgeHandle e = edges[start].next; e != start; e = edges[e].next)
+				edges[e].incident_face = face;
+		}
+
+		std::sort(touched.begin(), touched.end());
+		touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+		for (FaceHandle f : touched)
+			if (faces[f].visit != kept)
+				eraseFace(f);
+
+		for (EdgeHandle e : removed)
+			eraseEdge(e);
+
+		return removed.size();
+	}
+
+	template<class type, size_t dim>
+	inline void ArenaPolygonDCEL<type, dim>::clear()
+	{
+		std::vector<Vertex>().swap(vertices);
+		std::vector<Edge>().swap(edges);
+		std::vector<Face>().swap(faces);
+		std::vector<HoleLink>().swap(hole_pool);
+		std::vector<EdgeHandle>().swap(free_edges);
+		std::vector<FaceHandle>().swap(free_faces);
+		visit_mark = 0;
+	}
+
+	template<class type, size_t dim>
+	inline std::vector<typename ArenaPolygonDCEL<type, dim>::VertexHandle> ArenaPolygonDCEL<type, dim>::getVertexList() const
+	{
+		std::vector<VertexHandle> list(vertices.size());
+		for (uint32_t i = 0; i < list.size(); i++)
+			list[i] = i;
+		return list;
+	}
+
+	template<class type, size_t dim>
+	inline std::vector<typename ArenaPolygonDCEL<type, dim>::FaceHandle> ArenaPolygonDCEL<type, dim>::getFaceList() const
+	{
+		std::vector<FaceHandle> list;
+		list.reserve(faces.size() - free_faces.size());
+		for (uint32_t i = 0; i < faces.size(); i++)
+			if (!faces[i].removed)
+				list.push_back(i);
+		return list;
+	}
+
+	template<class type, size_t dim>
+	inline std::vector<typename ArenaPolygonDCEL<type, dim>::EdgeHandle> ArenaPolygonDCEL<type, dim>::getEdgeList() const
+	{
+		std::vector<EdgeHandle> list;
+		list.reserve(edgeCount());
+		for (uint32_t i = 0; i < edges.size(); i++)
+			if (edges[i].origin != DCEL_NULL)
+				list.push_back(i);
+		return list;
+	}
+
+	template<class type, size_t dim>
+	inline typename ArenaPolygonDCEL<type, dim>::VertexHandle ArenaPolygonDCEL<type, dim>::getVertex(const VectorNf& _point) const
+	{
+		for (uint32_t i = 0; i < vertices.size(); i++)
+			if (_point == vertices[i].point)
+				return i;
+		return DCEL_NULL;
+	}
+}
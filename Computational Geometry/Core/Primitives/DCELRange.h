@@ -0,0 +1,135 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Lightweight ranges used to walk a DCEL with range for loops. They only hold a few handles and
+// never allocate, the elements are produced while iterating. Both PolygonDCEL and ArenaPolygonDCEL
+// hand them out (faceBoundary, edgeCycle, vertexStar, vertexRange, ...).
+// A range is invalidated by any change to the part of the DCEL it walks.
+
+namespace jmk {
+
+	// Circular walk start, step(start), step(step(start)), ... stopping when it gets back to start.
+	// Face boundaries use step = next, vertex stars use step = twin->next.
+	template<class Handle, class Step>
+	class CirculatorRange
+	{
+		Handle start;
+		Step step;
+		bool empty;
+
+	public:
+		class iterator
+		{
+			Handle current;
+			Handle start;
+			Step step;
+			bool lapped;            // Back at start after going round once, this is the end position
+
+		public:
+			iterator(Handle _current, Handle _start, Step _step, bool _lapped)
+				: current(_current), start(_start), step(_step), lapped(_lapped) {}
+
+			Handle operator*() const { return current; }
+
+			iterator& operator++()
+			{
+				current = step(current);
+				lapped = current == start;
+				return *this;
+			}
+
+			bool operator==(const iterator& _other) const { return current == _other.current && lapped == _other.lapped; }
+			bool operator!=(const iterator& _other) const { return !(*this == _other); }
+		};
+
+		// _empty is for walks that have nothing to start from, e.g. the boundary of the unbounded face
+		CirculatorRange(Handle _start, Step _step, bool _empty = false) : start(_start), step(_step), empty(_empty) {}
+
+		iterator begin() const { return iterator(start, start, step, empty); }
+		iterator end() const { return iterator(start, start, step, true); }
+	};
+
+	// The non null entries of a slot array, e.g. the edges and faces of a PolygonDCEL
+	template<class T>
+	class NonNullRange
+	{
+		const std::vector<T*>* slots;
+
+	public:
+		class iterator
+		{
+			T* const* current;
+			T* const* last;
+
+			void skip()
+			{
+				while (current != last && *current == nullptr)
+					++current;
+			}
+
+		public:
+			iterator(T* const* _current, T* const* _last) : current(_current), last(_last) { skip(); }
+
+			T* operator*() const { return *current; }
+
+			iterator& operator++()
+			{
+				++current;
+				skip();
+				return *this;
+			}
+
+			bool operator==(const iterator& _other) const { return current == _other.current; }
+			bool operator!=(const iterator& _other) const { return current != _other.current; }
+		};
+
+		NonNullRange(const std::vector<T*>& _slots) : slots(&_slots) {}
+
+		iterator begin() const { return iterator(slots->data(), slots->data() + slots->size()); }
+		iterator end() const { return iterator(slots->data() + slots->size(), slots->data() + slots->size()); }
+	};
+
+	// The handles 0 .. count - 1 for which keep(handle) is true, e.g. the live edges of an ArenaPolygonDCEL
+	template<class Keep>
+	class HandleRange
+	{
+		uint32_t count;
+		Keep keep;
+
+	public:
+		class iterator
+		{
+			uint32_t current;
+			uint32_t count;
+			Keep keep;
+
+			void skip()
+			{
+				while (current != count && !keep(current))
+					++current;
+			}
+
+		public:
+			iterator(uint32_t _current, uint32_t _count, Keep _keep) : current(_current), count(_count), keep(_keep) { skip(); }
+
+			uint32_t operator*() const { return current; }
+
+			iterator& operator++()
+			{
+				++current;
+				skip();
+				return *this;
+			}
+
+			bool operator==(const iterator& _other) const { return current == _other.current; }
+			bool operator!=(const iterator& _other) const { return current != _other.current; }
+		};
+
+		HandleRange(uint32_t _count, Keep _keep) : count(_count), keep(_keep) {}
+
+		iterator begin() const { return iterator(0, count, keep); }
+		iterator end() const { return iterator(count, count, keep); }
+	};
+}
@@ -1,11 +1,20 @@
 #include "../Base/Core.h"
 #include "Intersection.h"
 #include "../GeoUtils.h"
+#include "../Predicates.h"
 
 using namespace jmk;
 
-bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::Point2d& c, const jmk::Point2d& d)
+template<class coord_type>
+static bool segment_intersection(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c, const Vector<coord_type, DIM2>& d)
 {
+	// In the general position case the signs alone decide, the RELATIVE_POSITION classification
+	// below is only needed when some of the points are collinear.
+	double ab_c_sign = orient2d(a, b, c), ab_d_sign = orient2d(a, b, d);
+	double cd_a_sign = orient2d(c, d, a), cd_b_sign = orient2d(c, d, b);
+
+	if (ab_c_sign != 0.0 && ab_d_sign != 0.0 && cd_a_sign != 0.0 && cd_b_sign != 0.0)
+		return _xor(ab_c_sign > 0.0, ab_d_sign > 0.0) && _xor(cd_a_sign > 0.0, cd_b_sign > 0.0);
 
 	auto ab_c = jmk::orientation2d(a, b, c);
 	auto ab_d = jmk::orientation2d(a, b, d);
@@ -24,18 +33,53 @@ bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::
 	return _xor(ab_c == LEFT, ab_d == LEFT) && _xor(cd_a == LEFT, cd_b == LEFT);
 }
 
+bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::Point2d& c, const jmk::Point2d& d)
+{
+	return segment_intersection(a, b, c, d);
+}
+
+bool jmk::Intersection(const jmk::Point2lf& a, const jmk::Point2lf& b, const jmk::Point2lf& c, const jmk::Point2lf& d)
+{
+	return segment_intersection(a, b, c, d);
+}
+
+bool jmk::Intersection(const jmk::Point2i& a, const jmk::Point2i& b, const jmk::Point2i& c, const jmk::Point2i& d)
+{
+	int ab_c_sign = orient2d(a, b, c), ab_d_sign = orient2d(a, b, d);
+	int cd_a_sign = orient2d(c, d, a), cd_b_sign = orient2d(c, d, b);
+
+	if (ab_c_sign != 0 && ab_d_sign != 0 && cd_a_sign != 0 && cd_b_sign != 0)
+		return ab_c_sign != ab_d_sign && cd_a_sign != cd_b_sign;
+
+	auto ab_c = jmk::orientation2d(a, b, c);
+	auto ab_d = jmk::orientation2d(a, b, d);
+	auto cd_a = jmk::orientation2d(c, d, a);
+	auto cd_b = jmk::orientation2d(c, d, b);
+
+	if (ab_c == BETWEEN || ab_c == ORIGIN || ab_c == DESTINATION
+		|| ab_d == BETWEEN || ab_d == ORIGIN || ab_d == DESTINATION
+		|| cd_a == BETWEEN || cd_a == ORIGIN || cd_a == DESTINATION
+		|| cd_b == BETWEEN || cd_b == ORIGIN || cd_b == DESTINATION)
+	{
+		return true;
+	}
+
+	return _xor(ab_c == LEFT, ab_d == LEFT) && _xor(cd_a == LEFT, cd_b == LEFT);
+}
+
 
 // Function to calculate the intersection of two line segments defined by points a to b and c to d.
 // If the segments intersect, the intersection point is stored in the 'intersection' variable and the function returns true.
 // If the segments do not intersect, the function returns false.
-bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::Point2d& c, const jmk::Point2d& d, jmk::Point2d& intersection)
+template<class coord_type>
+static bool segment_intersection(const Vector<coord_type, DIM2>& a, const Vector<coord_type, DIM2>& b, const Vector<coord_type, DIM2>& c, const Vector<coord_type, DIM2>& d, Vector<coord_type, DIM2>& intersection)
 {
     // Calculate the direction vectors of the line segments AB and CD
-    Vector2f AB = b - a;
-    Vector2f CD = d - c;
+    auto AB = b - a;
+    auto CD = d - c;
 
     // Calculate the normal vector to CD. This is a vector perpendicular to CD. (counterclockwise)
-    Vector2f n(CD[Y], -CD[X]);
+    Vector<coord_type, DIM2> n(CD[Y], -CD[X]);
     // siempre funciona esto, se puede probar en geoalgebra.
 
     // Calculate the dot product of the normal vector n and the direction vector AB
@@ -76,10 +120,21 @@ bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::
     }
 }
 
+bool jmk::Intersection(const jmk::Point2d& a, const jmk::Point2d& b, const jmk::Point2d& c, const jmk::Point2d& d, jmk::Point2d& intersection)
+{
+    return segment_intersection(a, b, c, d, intersection);
+}
+
+bool jmk::Intersection(const jmk::Point2lf& a, const jmk::Point2lf& b, const jmk::Point2lf& c, const jmk::Point2lf& d, jmk::Point2lf& intersection)
+{
+    return segment_intersection(a, b, c, d, intersection);
+}
+
 // Function to calculate the intersection of two lines defined by jmk::Line2d objects l1 and l2.
 // If the lines intersect, the intersection point is stored in the 'intersection' variable and the function returns true.
 // If the lines do not intersect, the function returns false.
-bool jmk::Intersection(const jmk::Line2dStd& l1, const jmk::Line2dStd& l2, jmk::Point2d& intersection)
+template<class coord_type>
+bool jmk::Intersection(const jmk::LineStd<coord_type, DIM2>& l1, const jmk::LineStd<coord_type, DIM2>& l2, jmk::Vector<coord_type, DIM2>& intersection)
 {
     // Get the starting point of the first line
     auto l1_start = l1.getPoint();
@@ -102,7 +157,8 @@ bool jmk::Intersection(const jmk::Line2dStd& l1, const jmk::Line2dStd& l2, jmk::
     return Intersection(l1_start, l1_end, l2_start, l2_end, intersection);
 }
 
-bool jmk::Intersection(const jmk::Line3dStd& line, const jmk::Planef& plane, jmk::Point3d& point)
+template<class coord_type>
+bool jmk::Intersection(const jmk::LineStd<coord_type, DIM3>& line, const jmk::Plane<coord_type>& plane, jmk::Vector<coord_type, DIM3>& point)
 {
     auto n = plane.getNormal();
     auto D = plane.getD();
@@ -125,7 +181,8 @@ bool jmk::Intersection(const jmk::Line3dStd& line, const jmk::Planef& plane, jmk
     }
 }
 
-bool jmk::intersect(const jmk::Planef& p1, const jmk::Planef& p2, jmk::Line& l)
+template<class coord_type>
+bool jmk::intersect(const jmk::Plane<coord_type>& p1, const jmk::Plane<coord_type>& p2, jmk::LineT<coord_type>& l)
 {
     auto n1 = p1.getNormal();
     auto n2 = p2.getNormal();
@@ -155,4 +212,9 @@ bool jmk::intersect(const jmk::Planef& p1, const jmk::Planef& p2, jmk::Line& l)
 
 }
 
-
+template bool jmk::Intersection<float>(const Line2dStd&, const Line2dStd&, Point2d&);
+template bool jmk::Intersection<double>(const Line2lfStd&, const Line2lfStd&, Point2lf&);
+template bool jmk::Intersection<float>(const Line3dStd&, const Planef&, Point3d&);
+template bool jmk::Intersection<double>(const Line3lfStd&, const Planelf&, Point3lf&);
+template bool jmk::intersect<float>(const Planef&, const Planef&, Line&);
+template bool jmk::intersect<double>(const Planelf&, const Planelf&, Line3lf&);
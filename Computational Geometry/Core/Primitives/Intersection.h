@@ -7,10 +7,21 @@ namespace jmk
 	bool Intersection(const jmk::Point2d&, const jmk::Point2d&, const jmk::Point2d&, const jmk::Point2d&);
 	bool Intersection(const jmk::Point2d&, const jmk::Point2d&, const jmk::Point2d&, const jmk::Point2d&, jmk::Point2d&);
 
-	bool Intersection(const jmk::Line2dStd&, const jmk::Line2dStd&, jmk::Point2d&);
+	bool Intersection(const jmk::Point2lf&, const jmk::Point2lf&, const jmk::Point2lf&, const jmk::Point2lf&);
+	bool Intersection(const jmk::Point2lf&, const jmk::Point2lf&, const jmk::Point2lf&, const jmk::Point2lf&, jmk::Point2lf&);
 
-	bool Intersection(const jmk::Line3dStd& line, const jmk::Planef& plane, jmk::Point3d& point);
+	// Exact segment intersection test for integer points
+	bool Intersection(const jmk::Point2i&, const jmk::Point2i&, const jmk::Point2i&, const jmk::Point2i&);
 
-	bool intersect(const jmk::Planef& p1, const jmk::Planef& p2, jmk::Line& l);
+	// Line and plane versions are instantiated for float and double coordinates
+
+	template<class coord_type>
+	bool Intersection(const jmk::LineStd<coord_type, DIM2>&, const jmk::LineStd<coord_type, DIM2>&, jmk::Vector<coord_type, DIM2>&);
+
+	template<class coord_type>
+	bool Intersection(const jmk::LineStd<coord_type, DIM3>& line, const jmk::Plane<coord_type>& plane, jmk::Vector<coord_type, DIM3>& point);
+
+	template<class coord_type>
+	bool intersect(const jmk::Plane<coord_type>& p1, const jmk::Plane<coord_type>& p2, jmk::LineT<coord_type>& l);
 
 }
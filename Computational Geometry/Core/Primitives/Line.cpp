@@ -1,40 +1,52 @@
 #include "Line.h"
 
-void jmk::Line::setDirection(Vector3f& _dir)
+template<class coord_type>
+void jmk::LineT<coord_type>::setDirection(Vector<coord_type, DIM3>& _dir)
 {
 	dir.assign(X, _dir[X]);
 	dir.assign(Y, _dir[Y]);
 	dir.assign(Z, _dir[Z]);
 }
 
-void jmk::Line::setPoint(Point3d& _point)
+template<class coord_type>
+void jmk::LineT<coord_type>::setPoint(Vector<coord_type, DIM3>& _point)
 {
 	point_in_line.assign(X, _point[X]);
 	point_in_line.assign(Y, _point[Y]);
 	point_in_line.assign(Z, _point[Z]);
 }
 
-jmk::Vector3f jmk::Line::direction() const
+template<class coord_type>
+jmk::Vector<coord_type, DIM3> jmk::LineT<coord_type>::direction() const
 {
 	return dir;
 }
 
-jmk::Point3d jmk::Line::point() const
+template<class coord_type>
+jmk::Vector<coord_type, DIM3> jmk::LineT<coord_type>::point() const
 {
 	return point_in_line;
 }
 
-jmk::Vector2f jmk::Line2d::direction() const
+template<class coord_type>
+jmk::Vector<coord_type, DIM2> jmk::Line2dT<coord_type>::direction() const
 {
 	return dir;
 }
 
-jmk::Point2d jmk::Line2d::point() const
+template<class coord_type>
+jmk::Vector<coord_type, DIM2> jmk::Line2dT<coord_type>::point() const
 {
 	return point_in_line;
 }
 
-jmk::Vector2f jmk::Line2d::normal() const
+template<class coord_type>
+jmk::Vector<coord_type, DIM2> jmk::Line2dT<coord_type>::normal() const
 {
 	return normal_vec;
 }
+
+template class jmk::LineT<float>;
+template class jmk::LineT<double>;
+template class jmk::Line2dT<float>;
+template class jmk::Line2dT<double>;
@@ -3,40 +3,44 @@
 #include "Point.h"
 
 namespace jmk {
-	class Line {
-		Vector3f dir;				// Normalized direction vector. 
-		Point3d point_in_line;
+	// Instantiated for float (Line) and double (Line3lf)
+	template<class coord_type = float>
+	class LineT {
+		Vector<coord_type, DIM3> dir;				// Normalized direction vector. 
+		Vector<coord_type, DIM3> point_in_line;
 
 	public:
 
-		Line() {}
+		LineT() {}
 
-		Line(Point3d& p1, Point3d& p2)
+		LineT(Vector<coord_type, DIM3>& p1, Vector<coord_type, DIM3>& p2)
 		{
 			point_in_line = p1;
 			dir = p2 - p1;
 			dir.normalize();
 		}
 
-		void setDirection(Vector3f&);
+		void setDirection(Vector<coord_type, DIM3>&);
 
-		void setPoint(Point3d&);
+		void setPoint(Vector<coord_type, DIM3>&);
 
-		Vector3f direction() const;
+		Vector<coord_type, DIM3> direction() const;
 
-		Point3d point() const;
+		Vector<coord_type, DIM3> point() const;
 	};
 
-	class Line2d {
-		Vector2f dir;
-		Point2d point_in_line;
-		Vector2f normal_vec;
+	// Instantiated for float (Line2d) and double (Line2lf)
+	template<class coord_type = float>
+	class Line2dT {
+		Vector<coord_type, DIM2> dir;
+		Vector<coord_type, DIM2> point_in_line;
+		Vector<coord_type, DIM2> normal_vec;
 
 	public:
 
-		Line2d() {}
+		Line2dT() {}
 
-		Line2d(Point2d& p1, Vector2f& _dir)
+		Line2dT(Vector<coord_type, DIM2>& p1, Vector<coord_type, DIM2>& _dir)
 		{
 			point_in_line = p1;
 			dir = _dir;
@@ -45,19 +49,24 @@ namespace jmk {
 			normal_vec.assign(Y, dir[X]);
 		}
 
-		Vector2f direction() const;
+		Vector<coord_type, DIM2> direction() const;
 
-		Point2d point() const;
+		Vector<coord_type, DIM2> point() const;
 
-		Vector2f normal() const;
+		Vector<coord_type, DIM2> normal() const;
 	};
 
+	typedef LineT<float>		Line;
+	typedef LineT<double>		Line3lf;
+	typedef Line2dT<float>		Line2d;
+	typedef Line2dT<double>		Line2lf;
+
 	template<class coord_type, size_t dim = DIM3>
 	class LineStd {
 		Vector<coord_type, dim> point;
 		Vector<coord_type, dim> dir;
 		Vector<coord_type, dim> second;
-		float d;
+		real_t<coord_type> d;
 
 	public:
 		LineStd() {}
@@ -80,13 +89,13 @@ namespace jmk {
 
 		Vector<coord_type, dim> getDir() const;
 
-		float getD() const;
+		real_t<coord_type> getD() const;
 
 		void setDirection(Vector<coord_type, dim>& _dir);
 
 		void setPoint(Vector<coord_type, dim>& _point);
 
-		void setD(float value);
+		void setD(real_t<coord_type> value);
 
 	};
 
@@ -109,7 +118,7 @@ namespace jmk {
 	}
 
 	template<class coord_type, size_t dim>
-	inline float LineStd<coord_type, dim>::getD() const
+	inline real_t<coord_type> LineStd<coord_type, dim>::getD() const
 	{
 		return d;
 	}
@@ -127,11 +136,13 @@ namespace jmk {
 	}
 
 	template<class coord_type, size_t dim>
-	inline void LineStd<coord_type, dim>::setD(float value)
+	inline void LineStd<coord_type, dim>::setD(real_t<coord_type> value)
 	{
 		d = value;
 	}
 
 	typedef LineStd<float, DIM2> Line2dStd;
 	typedef LineStd<float, DIM3> Line3dStd;
+	typedef LineStd<double, DIM2> Line2lfStd;
+	typedef LineStd<double, DIM3> Line3lfStd;
 }
\ No newline at end of file
@@ -9,18 +9,18 @@ namespace jmk
 	class Plane
 	{
 
-		Vector3f normal;
-		float d = 0;
+		Vector<coord_type, DIM3> normal;
+		real_t<coord_type> d = 0;
 
 	public:
 		Plane(){}
 
-		Plane(Vector3f& _normal, float _constant):normal(_normal), d(_constant)
+		Plane(Vector<coord_type, DIM3>& _normal, real_t<coord_type> _constant):normal(_normal), d(_constant)
 		{
 			normal.normalize();
 		}
 
-		Plane(Point3d& _p1, Point3d& _p2, Point3d& _p3 )
+		Plane(Vector<coord_type, DIM3>& _p1, Vector<coord_type, DIM3>& _p2, Vector<coord_type, DIM3>& _p3 )
 		{
 			auto v1 = _p2 - _p1;
 			auto v2 = _p3 - _p1;
@@ -30,16 +30,17 @@ namespace jmk
 			d = dotProduct(normal, _p1);
 		}
 
-		Vector3f getNormal() const
+		Vector<coord_type, DIM3> getNormal() const
 		{
 			return normal;
 		}
 
-		float getD() const
+		real_t<coord_type> getD() const
 		{
 			return d;
 		}
 	};
 
 	typedef  Plane<float> Planef;
+	typedef  Plane<double> Planelf;
 }
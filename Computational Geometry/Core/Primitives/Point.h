@@ -7,4 +7,14 @@ namespace jmk
 	typedef Vector2f Point2d;
 	typedef Vector3f Point3d;
 
+	// 16 byte aligned 3D point for arrays processed with SIMD
+	typedef Vector3fA Point3dA;
+
+	// Double precision points, for inputs such as large GIS coordinates that do not fit a float
+	typedef Vector2lf Point2lf;
+	typedef Vector3lf Point3lf;
+
+	// Integer (for example quantized map) coordinates. Predicates on these points are exact.
+	typedef Vector2i Point2i;
+
 }
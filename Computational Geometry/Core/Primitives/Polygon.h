@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 
 #include "Point.h"
+#include "../Base/PointView.h"
 
 namespace jmk {
 	struct Vertex
@@ -17,28 +19,30 @@ namespace jmk {
 		Vertex(Point3d& _point, Vertex* _next = nullptr, Vertex* _prev = nullptr) : point(_point), next(_next), prev(_prev) {}
 	};
 
-	struct Vertex2dSimple {
-		Point2d point;
-		Vertex2dSimple* next = nullptr;
-		Vertex2dSimple* prev = nullptr;
+	template<class coord_type = float>
+	struct VertexSimple {
+		Vector<coord_type, DIM2> point;
+		VertexSimple* next = nullptr;
+		VertexSimple* prev = nullptr;
 		bool is_ear = false;
 		bool is_processed = false;
 
-		friend class Polygon2dSimple;
+		template<class> friend class PolygonSimple;
 
 	public:
-		Vertex2dSimple(Point2d& _point, Vertex2dSimple* _next = nullptr, Vertex2dSimple* _prev = nullptr) : point(_point), next(_next), prev(_prev) {}
+		VertexSimple(const Vector<coord_type, DIM2>& _point, VertexSimple* _next = nullptr, VertexSimple* _prev = nullptr) : point(_point), next(_next), prev(_prev) {}
 	};
 
-	struct Edge2dSimple {
-		Point2d p1;
-		Point2d p2;
-		Point2d fp1;
-		Point2d fp2;
+	template<class coord_type = float>
+	struct EdgeSimple {
+		Vector<coord_type, DIM2> p1;
+		Vector<coord_type, DIM2> p2;
+		Vector<coord_type, DIM2> fp1;
+		Vector<coord_type, DIM2> fp2;
 	public:
-		Edge2dSimple() {}
+		EdgeSimple() {}
 
-		Edge2dSimple(Point2d _p1, Point2d _p2) :p1(_p1), p2(_p2)
+		EdgeSimple(Vector<coord_type, DIM2> _p1, Vector<coord_type, DIM2> _p2) :p1(_p1), p2(_p2)
 		{}
 
 	};
@@ -58,29 +62,130 @@ namespace jmk {
 		std::vector<Point3d> getPoints();
 	};
 
-	class Polygon2dSimple {
-		std::vector<Vertex2dSimple*> vertex_list;
+	template<class coord_type = float>
+	class PolygonSimple {
+		typedef Vector<coord_type, DIM2> PointType;
+		std::vector<VertexSimple<coord_type>*> vertex_list;
 	public:
-		Polygon2dSimple();
+		PolygonSimple() {}
 
 		// Construct the Polyhon with given point set
-		Polygon2dSimple(std::vector<Point2d> _point_list);
+		PolygonSimple(const std::vector<PointType>& _point_list);
 
-		Polygon2dSimple(Vertex2dSimple* root_vertex);
+		// Construct the Polygon reading the points straight from an external buffer
+		PolygonSimple(const PointView<coord_type, DIM2>& _points);
 
-		void Insert(Point2d&);
+		PolygonSimple(VertexSimple<coord_type>* root_vertex);
+
+		void Insert(PointType&);
 
 		// If vert exist in the polygon, update the neighbour pointer accoidingly and remove the vertex.
-		void RemoveVertex(Vertex2dSimple* vert);
+		void RemoveVertex(VertexSimple<coord_type>* vert);
 
-		std::vector<Vertex2dSimple*> getVertices();
+		std::vector<VertexSimple<coord_type>*> getVertices();
 
 		// Return the points list of underline vertices
-		std::vector<Point2d> getPoints();
+		std::vector<PointType> getPoints();
 
 		int size();
 
 	};
 
+	typedef VertexSimple<float>		Vertex2dSimple;
+	typedef EdgeSimple<float>		Edge2dSimple;
+	typedef PolygonSimple<float>	Polygon2dSimple;
+
+	typedef VertexSimple<int32_t>	Vertex2iSimple;
+	typedef EdgeSimple<int32_t>		Edge2iSimple;
+	typedef PolygonSimple<int32_t>	Polygon2iSimple;
+
+	typedef VertexSimple<double>	Vertex2lfSimple;
+	typedef EdgeSimple<double>		Edge2lfSimple;
+	typedef PolygonSimple<double>	Polygon2lfSimple;
+
+	template<class coord_type>
+	inline PolygonSimple<coord_type>::PolygonSimple(const std::vector<PointType>& _point_list) : PolygonSimple(PointView<coord_type, DIM2>(_point_list)) {}
+
+	template<class coord_type>
+	inline PolygonSimple<coord_type>::PolygonSimple(const PointView<coord_type, DIM2>& _points)
+	{
+		vertex_list.reserve(_points.size());
+		for (size_t i = 0; i < _points.size(); i++)
+		{
+			vertex_list.push_back(new VertexSimple<coord_type>(_points[i]));
+		}
+
+		const unsigned int size = vertex_list.size();
+
+		for (size_t i = 0; i < size; i++)
+		{
+			vertex_list[i]->next = vertex_list[(i + 1) % size];
+
+			if (i != 0)
+				vertex_list[i]->prev = vertex_list[i - 1];
+			else
+				vertex_list[i]->prev = vertex_list[size - 1];
+		}
+	}
+
+	template<class coord_type>
+	inline PolygonSimple<coord_type>::PolygonSimple(VertexSimple<coord_type>* root_vertex)
+	{
+		vertex_list.push_back(root_vertex);
+		auto temp = root_vertex->next;
+
+		while (temp != root_vertex) {
+			vertex_list.push_back(temp);
+			temp = temp->next;
+		}
+	}
+
+	template<class coord_type>
+	inline void PolygonSimple<coord_type>::Insert(PointType& _point)
+	{
+		vertex_list.push_back(new VertexSimple<coord_type>(_point));
+		int size = vertex_list.size();
+		if (size > 1)
+		{
+			vertex_list[size - 1]->next = vertex_list[size - 2]->next;
+			vertex_list[size - 2]->next = vertex_list[size - 1];
+			vertex_list[size - 1]->prev = vertex_list[size - 2];
+			vertex_list[size - 1]->next->prev = vertex_list[size - 1];
+		}
+	}
+
+	template<class coord_type>
+	inline void PolygonSimple<coord_type>::RemoveVertex(VertexSimple<coord_type>* _vert)
+	{
+		auto itr = std::find(vertex_list.begin(), vertex_list.end(), _vert);
+		if (itr != vertex_list.end())
+		{
+			vertex_list.erase(itr);
+		}
+	}
+
+	template<class coord_type>
+	inline std::vector<Vector<coord_type, DIM2>> PolygonSimple<coord_type>::getPoints()
+	{
+		std::vector<PointType> point_list;
+		for (const VertexSimple<coord_type>* vertex : vertex_list)
+		{
+			point_list.push_back(vertex->point);
+		}
+		return point_list;
+	}
+
+	template<class coord_type>
+	inline int PolygonSimple<coord_type>::size()
+	{
+		return vertex_list.size();
+	}
+
+	template<class coord_type>
+	inline std::vector<VertexSimple<coord_type>*> PolygonSimple<coord_type>::getVertices()
+	{
+		return this->vertex_list;
+	}
+
 	void merge(Polygon& poly1, Polygon& poly2, Polygon& final_poly);
 }
@@ -3,11 +3,20 @@
 #include <vector>
 #include <iostream>
 #include <unordered_set>
+#include <algorithm>
 
 #include "Point.h"
+#include "../Base/PointView.h"
+#include "../Base/PointHash.h"
+#include "DCELRange.h"
+#include "../Predicates.h"
+
+// Thread safety: a DCEL owns all its vertices, edges and faces and the types share no global or
+// static state (edge ids and scratch marks are kept per polygon). So different polygons can be
+// built, split and joined on different threads at the same time. One polygon is not synchronised:
+// while a thread modifies it, no other thread may read or modify it.
 
 namespace jmk {
-	static int _id = 1;  // A static ID to assign unique IDs to edges in the DCEL
 
 	// Forward declarations of EdgeDCEL and FaceDCEL templates
 	template<class type, size_t dim >
@@ -20,12 +29,13 @@ namespace jmk {
 	template<class type = float, size_t dim = DIM3 >
 	struct VertexDCEL
 	{
-		Vector<float, dim> point;                                // Coordinates of the vertex
+		Vector<type, dim> point;                                 // Coordinates of the vertex
 		EdgeDCEL<type, dim>* incident_edge = nullptr;            // Pointer to an incident edge
 																 // An incident edge is an edge connected to a particular vertex
+		uint32_t index = 0;                                      // Position of the vertex in the points the polygon was built from
 
 		// Constructor to initialize the vertex with a given point
-		VertexDCEL(Vector<type, dim>& _point) : point(_point) {}
+		VertexDCEL(const Vector<type, dim>& _point) : point(_point) {}
 
 		
 		void print()
@@ -55,16 +65,14 @@ namespace jmk {
 		EdgeDCEL<type, dim>* next = nullptr;            // Next edge in counter-clockwise order
 		EdgeDCEL<type, dim>* prev = nullptr;            // Previous edge in counter-clockwise order
 		FaceDCEL<type, dim>* incident_face = nullptr;   // Face to which the edge belongs
-		int id;                                         // Unique ID of the edge
+		int id = -1;                                    // Position in the edge list of the owning polygon,
+		                                                // unique within it. -1 while the edge is not in one
 
-		// Default constructor initializes the edge with an invalid ID
-		EdgeDCEL() { id = -1; }
+		EdgeDCEL() {}
 
-		// Constructor initializes the edge with a given origin vertex and assigns a unique ID
-		EdgeDCEL(VertexDCEL<type, dim>* _origin) : origin(_origin)
-		{
-			id = _id++;  // Increment the static ID
-		}
+		// Constructor initializes the edge with a given origin vertex. The id is given by the polygon
+		// the edge is added to.
+		EdgeDCEL(VertexDCEL<type, dim>* _origin) : origin(_origin) {}
 
 		// Returns the destination vertex of the edge by accessing the twin's origin
 		VertexDCEL<type, dim>* destination()
@@ -86,6 +94,26 @@ namespace jmk {
 		}
 	};
 
+	// Steps of the allocation free walks over edge pointers (see DCELRange.h)
+	template<class type, size_t dim>
+	struct EdgeDCELNextStep
+	{
+		EdgeDCEL<type, dim>* operator()(EdgeDCEL<type, dim>* edge) const { return edge->next; }
+	};
+
+	template<class type, size_t dim>
+	struct EdgeDCELStarStep
+	{
+		EdgeDCEL<type, dim>* operator()(EdgeDCEL<type, dim>* edge) const { return edge->twin->next; }
+	};
+
+	// Edges of a boundary cycle in next order, and edges leaving a vertex
+	template<class type, size_t dim>
+	using EdgeDCELCycle = CirculatorRange<EdgeDCEL<type, dim>*, EdgeDCELNextStep<type, dim>>;
+
+	template<class type, size_t dim>
+	using EdgeDCELStar = CirculatorRange<EdgeDCEL<type, dim>*, EdgeDCELStarStep<type, dim>>;
+
 	// FaceDCEL structure representing a face in the DCEL
 	template<class type = float, size_t dim = DIM3 >
 	struct FaceDCEL
@@ -93,7 +121,16 @@ namespace jmk {
 		EdgeDCEL<type, dim>* outer = nullptr;                 // Pointer to one outer edge (boundary)
 		std::vector<EdgeDCEL<type, dim>*> inner;              // Inner edges representing holes in the face
 		// es un vector porque podrias tener varios huecos.
+
+		uint32_t slot = 0;                                    // Position in the face list of the owning polygon
+		size_t visit = 0;                                     // Scratch mark used by PolygonDCEL to find shared faces
+		EdgeDCEL<type, dim>* visit_edge = nullptr;            // Edge the face was reached through in that search
 		
+		// Edges of the outer boundary, without building a list. Empty for the unbounded face
+		EdgeDCELCycle<type, dim> boundary() const
+		{
+			return EdgeDCELCycle<type, dim>(outer, {}, outer == nullptr);
+		}
 	
 		// Print function to print the vertices of the face by following the outer edges
 		void print()
@@ -152,7 +189,6 @@ namespace jmk {
 				auto edge_ptr = outer;
 				auto next_ptr = outer->next;
 				edge_list.push_back(edge_ptr); // Add first edge to the list
-				edge_ptr->origin->print();
 				while (next_ptr != edge_ptr) 
 				{
 					edge_list.push_back(next_ptr);  // Add subsequent edges
@@ -183,9 +219,9 @@ namespace jmk {
 
 
 		// Returns a list of points (vertices) defining the boundary of the face
-		std::vector<Vector<float, dim>> getPoints()
+		std::vector<Vector<type, dim>> getPoints()
 		{
-			std::vector<Vector<float, dim>> point_list;
+			std::vector<Vector<type, dim>> point_list;
 			if (outer) {
 				auto edge_ptr = outer;
 				auto next_ptr = outer->next;
@@ -320,23 +356,55 @@ namespace jmk {
 	{
 		typedef Vector<type, dim> VectorNf;  // Alias for a vector of the specified type and dimension
 		std::vector<VertexDCEL<type, dim>*> vertex_list;  // List of vertices
-		std::vector<EdgeDCEL<type, dim>*> edge_list;      // List of edges
-		std::vector<FaceDCEL<type, dim>*> face_list;      // List of faces
-
-		EdgeDCEL<type, dim>* empty_edge = new EdgeDCEL<type, dim>();  // An empty edge used for initialization
+		std::vector<EdgeDCEL<type, dim>*> edge_list;      // Edge slots. A removed edge leaves a nullptr behind
+		std::vector<uint32_t> free_edge_slots;            // Empty slots of edge_list, filled before growing it
+		std::vector<FaceDCEL<type, dim>*> face_list;      // Face slots. A removed face leaves a nullptr behind
+		std::vector<uint32_t> free_face_slots;            // Empty slots of face_list, filled before growing it
+		size_t visit_mark = 0;                            // Last mark handed to FaceDCEL::visit
+		PointHash<type, dim> vertex_hash;                 // Vertex indices by coordinates, empty unless enabled
+		bool hash_vertices = false;                       // Whether getVertex goes through vertex_hash
+
+		// O(1) edge and face bookkeeping through the slots
+		void addEdge(EdgeDCEL<type, dim>* edge);
+		void eraseEdge(EdgeDCEL<type, dim>* edge);
+		void addFace(FaceDCEL<type, dim>* face);
+		void eraseFace(FaceDCEL<type, dim>* face);
+
+		// Take the edge and its twin out of the vertex stars and the face cycles, the faces are left as they are
+		void unlinkEdge(EdgeDCEL<type, dim>* edge);
 	public:
-		// Constructor initializes the DCEL from a given set of points
-		explicit PolygonDCEL(std::vector<VectorNf>&);
+		// Constructor initializes the DCEL from a given set of points. With _hash_vertices the vertices
+		// are also put in a spatial hash, so getVertex runs in expected O(1) instead of O(n).
+		explicit PolygonDCEL(std::vector<VectorNf>&, bool _hash_vertices = false);
+
+		// Same, reading the points straight from an external buffer
+		explicit PolygonDCEL(const PointView<type, dim>&, bool _hash_vertices = false);
 
 		// Insert an edge between two vertices, splitting the face
 		bool split(VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2);
+
+		// Insert all the given diagonals at once (2D only). The edges around every touched vertex are
+		// sorted by angle and linked, then the faces are rebuilt in one walk over the new cycles, instead
+		// of relabelling a face per diagonal. The diagonals must lie inside the polygon and must not
+		// cross each other. Pairs that are already joined by an edge are skipped.
+		// Returns the number of diagonals inserted.
+		size_t splitMany(const std::vector<std::pair<VertexDCEL<type, dim>*, VertexDCEL<type, dim>*>>& _diagonals);
+
 		void clear();
 
 		// Join two faces by removing the edge between two vertices
 		bool join(VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2);
 
+		// Same, for the edge given as its two halves. Only edges between two bounded faces (diagonals)
+		// can be removed. The four next / prev links around the edge are spliced and the smaller face
+		// is merged in to the larger one, so the cost is proportional to the smaller face.
 		bool join(EdgeDCEL<type, dim>* edge1, EdgeDCEL<type, dim>* edge2);
 
+		// Remove all the given diagonals at once, e.g. to coarsen a triangulation. Either half of an
+		// edge can be given, repeats and edges on the unbounded face are skipped. Every merged face is
+		// relabelled in a single walk. Returns the number of edges removed.
+		size_t joinMany(const std::vector<EdgeDCEL<type, dim>*>& _edges);
+
 		// Get a list of all vertices across all faces
 		std::vector<VertexDCEL<type, dim>*> getVertexList();
 
@@ -346,13 +414,72 @@ namespace jmk {
 		// Get a list of all edges
 		std::vector<EdgeDCEL<type, dim>*> getEdgeList();
 
-		// Get a vertex based on its coordinates
-		VertexDCEL<type, dim>* getVertex(VectorNf&);
+		// Get a vertex based on its coordinates. Coordinates are compared with TOLERANCE, when several
+		// vertices match the one built from the earliest point is returned.
+		VertexDCEL<type, dim>* getVertex(const VectorNf&);
+
+		// Batch version, one vertex (or nullptr) per point. Without the vertex hash a temporary one is
+		// built for the call, so the cost is O(n + m) rather than O(n * m).
+		std::vector<VertexDCEL<type, dim>*> getVertices(const std::vector<VectorNf>& _points);
+
+		// Build or drop the vertex hash used by getVertex. Vertices are only created by the
+		// constructor, split and join reuse them, so the hash stays valid until clear().
+		void setVertexHash(bool _enabled);
+		bool hasVertexHash() const { return hash_vertices; }
 
 		// Find edges with the same face and given origins
 		void getEdgesWithSamefaceAndGivenOrigins(VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2,
 			EdgeDCEL<type, dim>** edge_leaving_v1, EdgeDCEL<type, dim>** edge_leaving_v2);
 
+		// Handle accessors, same names as in ArenaPolygonDCEL so the algorithms can be written once for
+		// both. Here a handle is just the pointer.
+		typedef type coordinate_type;
+		typedef VertexDCEL<type, dim>* VertexHandle;
+		typedef EdgeDCEL<type, dim>* EdgeHandle;
+		typedef FaceDCEL<type, dim>* FaceHandle;
+
+		const VectorNf& point(VertexHandle v) const { return v->point; }
+		uint32_t index(VertexHandle v) const { return v->index; }
+		EdgeHandle incidentEdge(VertexHandle v) const { return v->incident_edge; }
+		VertexHandle origin(EdgeHandle e) const { return e->origin; }
+		VertexHandle destination(EdgeHandle e) const { return e->twin->origin; }
+		EdgeHandle twin(EdgeHandle e) const { return e->twin; }
+		EdgeHandle next(EdgeHandle e) const { return e->next; }
+		EdgeHandle prev(EdgeHandle e) const { return e->prev; }
+		FaceHandle incidentFace(EdgeHandle e) const { return e->incident_face; }
+		EdgeHandle outer(FaceHandle f) const { return f->outer; }
+		bool isBounded(FaceHandle f) const { return f->outer != nullptr; }
+
+		// Allocation free walks for range for loops, the get*List functions above copy instead.
+		// faceBoundary and edgeCycle follow next, vertexStar gives the edges leaving the vertex.
+		EdgeDCELCycle<type, dim> faceBoundary(FaceHandle f) const { return f->boundary(); }
+		EdgeDCELCycle<type, dim> edgeCycle(EdgeHandle e) const { return EdgeDCELCycle<type, dim>(e, {}); }
+		EdgeDCELStar<type, dim> vertexStar(VertexHandle v) const { return EdgeDCELStar<type, dim>(v->incident_edge, {}, v->incident_edge == nullptr); }
+		const std::vector<EdgeHandle>& holes(FaceHandle f) const { return f->inner; }   // One edge per hole, walk it with edgeCycle
+		const std::vector<VertexHandle>& vertexRange() const { return vertex_list; }
+		NonNullRange<EdgeDCEL<type, dim>> edgeRange() const { return edge_list; }
+		NonNullRange<FaceDCEL<type, dim>> faceRange() const { return face_list; }
+
+		size_t vertexCount() const { return vertex_list.size(); }
+
+		// Estimated bytes held by the lists and the vertices, edges and faces they point to. Every one of
+		// those is a separate heap block, counted with two pointers of allocator header (glibc malloc).
+		// The vertex hash is not included.
+		size_t memoryUsage() const
+		{
+			const size_t header = 2 * sizeof(void*);
+			size_t bytes = (vertex_list.capacity() + edge_list.capacity() + face_list.capacity()) * sizeof(void*)
+				+ (free_edge_slots.capacity() + free_face_slots.capacity()) * sizeof(uint32_t)
+				+ vertex_list.size() * (sizeof(VertexDCEL<type, dim>) + header);
+			for (auto edge : edge_list)
+				if (edge)
+					bytes += sizeof(EdgeDCEL<type, dim>) + header;
+			for (auto face : face_list)
+				if (face)
+					bytes += sizeof(FaceDCEL<type, dim>) + header + face->inner.capacity() * sizeof(void*);
+			return bytes;
+		}
+
 		// Helper functions to print the polygon
 		void printPolygon();
 		void printEdges();
@@ -381,7 +508,7 @@ namespace jmk {
 		for (auto& e : edge_list)
 		{
 			// Skip this edge if its twin has already been printed
-			if (printedEdges.find(e) != printedEdges.end())
+			if (!e || printedEdges.find(e) != printedEdges.end())
 			{
 				continue; // If the edge has already been printed, skip it
 			}
@@ -406,6 +533,8 @@ namespace jmk {
 		std::cout << "Faces: \n";
 		for (auto& f : face_list) 
 		{
+			if (!f)
+				continue;
 			std::cout << "Face Outer Boundary: \n";
 			EdgeDCEL<type, dim>* edge = f->outer;
 			if (edge) 
@@ -432,11 +561,25 @@ namespace jmk {
 	// Type aliases for 2D versions of the DCEL structures
 	typedef VertexDCEL<float, 2U>	Vertex2dDCEL;
 	typedef EdgeDCEL<float, 2U>	Edge2dDCEL;
+	typedef FaceDCEL<float, 2U>	Face2dDCEL;
 	typedef PolygonDCEL<float, 2U>	Polygon2d;
 
+	typedef VertexDCEL<int32_t, 2U>	Vertex2iDCEL;
+	typedef EdgeDCEL<int32_t, 2U>	Edge2iDCEL;
+	typedef FaceDCEL<int32_t, 2U>	Face2iDCEL;
+	typedef PolygonDCEL<int32_t, 2U>	Polygon2i;
+
+	typedef VertexDCEL<double, 2U>	Vertex2lfDCEL;
+	typedef EdgeDCEL<double, 2U>	Edge2lfDCEL;
+	typedef FaceDCEL<double, 2U>	Face2lfDCEL;
+	typedef PolygonDCEL<double, 2U>	Polygon2lf;
+
+	template<class type, size_t dim>
+	inline PolygonDCEL<type, dim>::PolygonDCEL(std::vector<VectorNf>& _points, bool _hash_vertices) : PolygonDCEL(PointView<type, dim>(_points), _hash_vertices) {}
+
 	// Constructor for the PolygonDCEL, builds the DCEL from a list of points
 	template<class type, size_t dim>
-	inline PolygonDCEL<type, dim>::PolygonDCEL(std::vector<VectorNf>& _points) {
+	inline PolygonDCEL<type, dim>::PolygonDCEL(const PointView<type, dim>& _points, bool _hash_vertices) {
 		int size = _points.size();
 		// A polygon must have at least 3 vertices
 		if (size < 3)
@@ -446,21 +589,22 @@ namespace jmk {
 		for (size_t i = 0; i < _points.size(); i++) 
 		{
 			vertex_list.push_back(new VertexDCEL<type, dim>(_points[i]));
+			vertex_list.back()->index = (uint32_t)i;
 		}
 
 		// Create half-edges and their twins connecting consecutive vertices
 		for (size_t i = 0; i <= vertex_list.size() - 2; i++) 
 		{
-			auto hfedge = new EdgeDCEL<float, 2>(vertex_list[i]);    // E_0
-			auto edge_twin = new EdgeDCEL<float, 2>(vertex_list[i + 1]); // E_1
+			auto hfedge = new EdgeDCEL<type, dim>(vertex_list[i]);    // E_0
+			auto edge_twin = new EdgeDCEL<type, dim>(vertex_list[i + 1]); // E_1
 
 			vertex_list[i]->incident_edge = hfedge; // Vertex A incident edge
 
 			hfedge->twin = edge_twin; // E_0 <-> E_1
 			edge_twin->twin = hfedge;
 
-			edge_list.push_back(hfedge); // Add E_0 to the list
-			edge_list.push_back(edge_twin); // Add E_1 to the list
+			addEdge(hfedge); // Add E_0 to the list
+			addEdge(edge_twin); // Add E_1 to the list
 		}
 
 		// El for loop es -2 aproposito para dejar afuera los ultimos dos vertices.
@@ -471,11 +615,14 @@ namespace jmk {
 
 		hfedge->twin = edge_twin;
 		edge_twin->twin = hfedge;
-		edge_list.push_back(hfedge);
-		edge_list.push_back(edge_twin);
+		addEdge(hfedge);
+		addEdge(edge_twin);
 
 		vertex_list[vertex_list.size() - 1]->incident_edge = hfedge;
 
+		if (_hash_vertices)
+			setVertexHash(true);
+
 		// Set the prev and next for the element middle of the list ( 2 : size- 2)
 		for (size_t i = 2; i <= edge_list.size()-3; i++) {
 			
@@ -514,8 +661,8 @@ namespace jmk {
 
 		f2->inner.push_back(edge_list[1]);
 
-		face_list.push_back(f1);
-		face_list.push_back(f2);
+		addFace(f1);
+		addFace(f2);
 
 		f1->outer->incident_face = f1;
 		EdgeDCEL<type, dim>* edge = f1->outer->next;
@@ -536,42 +683,108 @@ namespace jmk {
 	
 	}
 
-	// Helper function to get edges with the same face and given origins
 	template<class type, size_t dim>
-	inline void PolygonDCEL<type, dim>::getEdgesWithSamefaceAndGivenOrigins(
-		VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2,
-		EdgeDCEL<type, dim>** edge_leaving_v1, EdgeDCEL<type, dim>** edge_leaving_v2)
+	inline void PolygonDCEL<type, dim>::addEdge(EdgeDCEL<type, dim>* edge)
 	{
-		std::vector<EdgeDCEL<type, dim>*> edges_with_v1_ori, edges_with_v2_ori;
+		if (free_edge_slots.empty())
+		{
+			edge->id = (int)edge_list.size();
+			edge_list.push_back(edge);
+		}
+		else
+		{
+			edge->id = (int)free_edge_slots.back();
+			free_edge_slots.pop_back();
+			edge_list[edge->id] = edge;
+		}
+	}
 
-		// Gather all edges with origin _v1
-		auto v1_inci_edge = _v1->incident_edge;
-		edges_with_v1_ori.push_back(v1_inci_edge);
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::eraseEdge(EdgeDCEL<type, dim>* edge)
+	{
+		edge_list[edge->id] = nullptr;
+		free_edge_slots.push_back((uint32_t)edge->id);
+		delete edge;
+	}
 
-		auto next_edge = v1_inci_edge->twin->next;
-		while (next_edge != v1_inci_edge) {
-			edges_with_v1_ori.push_back(next_edge);
-			next_edge = next_edge->twin->next;
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::addFace(FaceDCEL<type, dim>* face)
+	{
+		if (free_face_slots.empty())
+		{
+			face->slot = (uint32_t)face_list.size();
+			face_list.push_back(face);
+		}
+		else
+		{
+			face->slot = free_face_slots.back();
+			free_face_slots.pop_back();
+			face_list[face->slot] = face;
 		}
+	}
 
-		// Gather all edges with origin _v2
-		auto v2_inci_edge = _v2->incident_edge;
-		edges_with_v2_ori.push_back(v2_inci_edge);
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::eraseFace(FaceDCEL<type, dim>* face)
+	{
+		face_list[face->slot] = nullptr;
+		free_face_slots.push_back(face->slot);
+		delete face;
+	}
 
-		next_edge = v2_inci_edge->twin->next;
-		while (next_edge != v2_inci_edge) {
-			edges_with_v2_ori.push_back(next_edge);
-			next_edge = next_edge->twin->next;
-		}
+	// Helper function to get edges with the same face and given origins
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::getEdgesWithSamefaceAndGivenOrigins(
+		VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2,
+		EdgeDCEL<type, dim>** edge_leaving_v1, EdgeDCEL<type, dim>** edge_leaving_v2)
+	{
+		*edge_leaving_v1 = nullptr;
+		*edge_leaving_v2 = nullptr;
+
+		// Walk the stars of both vertices together. Each bounded face met is marked with the side it
+		// was reached from and the edge it was reached through, so the first face reached from both
+		// sides is found in O(degree) without collecting the stars. The unbounded face (no outer
+		// boundary) is skipped, a diagonal never lies in it.
+		visit_mark += 2;
+		const size_t mark_v1 = visit_mark, mark_v2 = visit_mark + 1;
+
+		auto v1_edge = _v1->incident_edge, v2_edge = _v2->incident_edge;
+		bool v1_done = false, v2_done = false;
+		while (!v1_done || !v2_done)
+		{
+			if (!v1_done)
+			{
+				auto face = v1_edge->incident_face;
+				if (face && face->outer)
+				{
+					if (face->visit == mark_v2)
+					{
+						*edge_leaving_v1 = v1_edge;
+						*edge_leaving_v2 = face->visit_edge;
+						return;
+					}
+					face->visit = mark_v1;
+					face->visit_edge = v1_edge;
+				}
+				v1_edge = v1_edge->twin->next;
+				v1_done = v1_edge == _v1->incident_edge;
+			}
 
-		// Find edges incident to the same face
-		for (auto ev1 : edges_with_v1_ori) {
-			for (auto ev2 : edges_with_v2_ori) {
-				if (ev1->incident_face == ev2->incident_face) {
-					*edge_leaving_v1 = ev1;
-					*edge_leaving_v2 = ev2;
-					return;
+			if (!v2_done)
+			{
+				auto face = v2_edge->incident_face;
+				if (face && face->outer)
+				{
+					if (face->visit == mark_v1)
+					{
+						*edge_leaving_v1 = face->visit_edge;
+						*edge_leaving_v2 = v2_edge;
+						return;
+					}
+					face->visit = mark_v2;
+					face->visit_edge = v2_edge;
 				}
+				v2_edge = v2_edge->twin->next;
+				v2_done = v2_edge == _v2->incident_edge;
 			}
 		}
 	}
@@ -585,23 +798,20 @@ namespace jmk {
 		getEdgesWithSamefaceAndGivenOrigins(_v1, _v2, &edge_oriV1, &edge_oriV2);
 
 		// If the edges with origins _v1 and _v2 are not found, return false (i.e., cannot perform the split).
-		if (edge_oriV1->id == -1 || edge_oriV2->id == -1)
+		if (!edge_oriV1 || !edge_oriV2 || edge_oriV1->id == -1 || edge_oriV2->id == -1)
 			return false;
 
 		// If _v1 and _v2 are adjacent, no need to split, so return false.
 		if (edge_oriV1->next->origin == _v2 || edge_oriV1->prev->origin == _v2)
 			return false;
 
-		// Save the current face before splitting so we can remove it later.
-		FaceDCEL<type, dim>* previous_face = edge_oriV1->incident_face;
-
 		// Create two new half-edges between _v1 and _v2. These will form the new edge from _v1 to _v2.
 		auto half_edge1 = new EdgeDCEL<type, dim>(_v1);
 		auto half_edge2 = new EdgeDCEL<type, dim>(_v2);
 
 		// Add the new edges to the edge list
-		this->edge_list.push_back(half_edge1);
-		this->edge_list.push_back(half_edge2);
+		addEdge(half_edge1);
+		addEdge(half_edge2);
 
 		// Set each half-edge as the twin of the other, creating a bidirectional connection.
 		half_edge1->twin = half_edge2;
@@ -622,45 +832,158 @@ namespace jmk {
 		half_edge1->prev->next = half_edge1;
 		half_edge2->prev->next = half_edge2;
 
-		// Create two new faces from the split. 
-		FaceDCEL<type, dim>* new_face1 = new FaceDCEL<type, dim>();
-		new_face1->outer = half_edge1;
-		half_edge1->incident_face = new_face1;
-
-		// Traverse all edges starting from half_edge1 and assign them to new_face1.
-		auto temp_edge = half_edge1->next;
-		while (temp_edge != half_edge1) 
+		// The old face keeps one side and a new face takes the other. Walking both cycles together
+		// stops at the end of the shorter one, which is the only side that has to be relabelled.
+		FaceDCEL<type, dim>* previous_face = edge_oriV1->incident_face;
+		auto walk1 = half_edge1->next, walk2 = half_edge2->next;
+		while (walk1 != half_edge1 && walk2 != half_edge2)
 		{
-			temp_edge->incident_face = new_face1;
-			temp_edge = temp_edge->next;
+			walk1 = walk1->next;
+			walk2 = walk2->next;
 		}
+		auto moved_edge = walk1 == half_edge1 ? half_edge1 : half_edge2;
+		auto kept_edge = moved_edge->twin;
 
-		// Similarly, create the second new face for the other half.
-		FaceDCEL<type, dim>* new_face2 = new FaceDCEL<type, dim>();
-		new_face2->outer = half_edge2;
-		half_edge2->incident_face = new_face2;
+		previous_face->outer = kept_edge;
+		kept_edge->incident_face = previous_face;
 
-		// Traverse all edges starting from half_edge2 and assign them to new_face2.
-		temp_edge = half_edge2->next;
-		while (temp_edge != half_edge2) 
-		{
-			temp_edge->incident_face = new_face2;
+		FaceDCEL<type, dim>* new_face = new FaceDCEL<type, dim>();
+		new_face->outer = moved_edge;
+		auto temp_edge = moved_edge;
+		do {
+			temp_edge->incident_face = new_face;
 			temp_edge = temp_edge->next;
+		} while (temp_edge != moved_edge);
+		addFace(new_face);
+
+		// Successfully performed the split, return true.
+		return true;
+	}
+
+	template<class type, size_t dim>
+	inline size_t PolygonDCEL<type, dim>::splitMany(const std::vector<std::pair<VertexDCEL<type, dim>*, VertexDCEL<type, dim>*>>& _diagonals)
+	{
+		typedef VertexDCEL<type, dim> Vertex;
+		typedef EdgeDCEL<type, dim> Edge;
+
+		// Drop repeated pairs, in either direction. Vertices are ordered by index and edges by id rather
+		// than by address, so the ids and face slots handed out do not depend on the heap layout.
+		std::vector<std::pair<Vertex*, Vertex*>> diagonals;
+		diagonals.reserve(_diagonals.size());
+		for (auto& d : _diagonals)
+			if (d.first != d.second)
+				diagonals.push_back(d.first->index < d.second->index ? d : std::make_pair(d.second, d.first));
+		std::sort(diagonals.begin(), diagonals.end(), [](const std::pair<Vertex*, Vertex*>& a, const std::pair<Vertex*, Vertex*>& b) {
+			return a.first->index < b.first->index || (a.first == b.first && a.second->index < b.second->index);
+		});
+		diagonals.erase(std::unique(diagonals.begin(), diagonals.end()), diagonals.end());
+
+		auto connected = [](Vertex* a, Vertex* b) {
+			Edge* edge = a->incident_edge;
+			do {
+				if (edge->twin->origin == b)
+					return true;
+				edge = edge->twin->next;
+			} while (edge != a->incident_edge);
+			return false;
+		};
+
+		// Create the half edges, keyed by their origin
+		std::vector<std::pair<Vertex*, Edge*>> new_edges;
+		new_edges.reserve(2 * diagonals.size());
+		for (auto& d : diagonals)
+		{
+			if (connected(d.first, d.second))
+				continue;
+
+			auto half_edge1 = new Edge(d.first);
+			auto half_edge2 = new Edge(d.second);
+			half_edge1->twin = half_edge2;
+			half_edge2->twin = half_edge1;
+
+			addEdge(half_edge1);
+			addEdge(half_edge2);
+			new_edges.push_back({ d.first, half_edge1 });
+			new_edges.push_back({ d.second, half_edge2 });
 		}
+		std::sort(new_edges.begin(), new_edges.end(), [](const std::pair<Vertex*, Edge*>& a, const std::pair<Vertex*, Edge*>& b) {
+			return a.first->index < b.first->index || (a.first == b.first && a.second->id < b.second->id);
+		});
+
+		// Counter-clockwise order of the outgoing edges around a vertex, starting from the +X direction
+		auto upper_half = [](const Vector<type, dim>& origin, const Vector<type, dim>& p) {
+			return p[Y] > origin[Y] || (p[Y] == origin[Y] && p[X] > origin[X]);
+		};
+
+		std::vector<Edge*> around;
+		std::vector<FaceDCEL<type, dim>*> old_faces;
+		for (size_t first = 0; first < new_edges.size(); )
+		{
+			Vertex* vertex = new_edges[first].first;
+			const auto& origin = vertex->point;
 
-		// Add the two new faces to the face list.
-		face_list.push_back(new_face1);
-		face_list.push_back(new_face2);
+			// The existing edges are still linked, so they can be circulated before the new ones join
+			around.clear();
+			Edge* edge = vertex->incident_edge;
+			do {
+				around.push_back(edge);
+				edge = edge->twin->next;
+			} while (edge != vertex->incident_edge);
+
+			size_t last = first;
+			for (; last < new_edges.size() && new_edges[last].first == vertex; last++)
+				around.push_back(new_edges[last].second);
+
+			std::sort(around.begin(), around.end(), [&](const Edge* a, const Edge* b) {
+				const auto& pa = a->twin->origin->point;
+				const auto& pb = b->twin->origin->point;
+				bool upper_a = upper_half(origin, pa), upper_b = upper_half(origin, pb);
+				if (upper_a != upper_b)
+					return upper_a;
+				return orient2d(origin, pa, pb) > 0;
+			});
+
+			// Going around a face, an edge coming in to the vertex continues with the next outgoing edge
+			// clockwise. Every old edge beside a new one belongs to a face that gets split.
+			const size_t count = around.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				Edge* current = around[i];
+				Edge* clockwise = around[(i + count - 1) % count];
+				current->twin->next = clockwise;
+				clockwise->prev = current->twin;
+
+				if (current->incident_face == nullptr && clockwise->incident_face)
+					old_faces.push_back(clockwise->incident_face);
+			}
 
-		// Find and remove the previous face from the face list, as it's now split into the two new faces.
-		auto itr = std::find(face_list.begin(), face_list.end(), previous_face);
-		if (itr != face_list.end()) {
-			face_list.erase(itr);
-			delete previous_face; // Free the memory for the old face.
+			first = last;
 		}
 
-		// Successfully performed the split, return true.
-		return true;
+		// Every face left after the split has at least one new edge on its boundary, so walking the
+		// cycles from the new edges visits each of them exactly once
+		for (auto& new_edge : new_edges)
+		{
+			Edge* start = new_edge.second;
+			if (start->incident_face)
+				continue;
+
+			FaceDCEL<type, dim>* face = new FaceDCEL<type, dim>();
+			face->outer = start;
+			Edge* edge = start;
+			do {
+				edge->incident_face = face;
+				edge = edge->next;
+			} while (edge != start);
+			addFace(face);
+		}
+
+		std::sort(old_faces.begin(), old_faces.end(), [](FaceDCEL<type, dim>* a, FaceDCEL<type, dim>* b) { return a->slot < b->slot; });
+		old_faces.erase(std::unique(old_faces.begin(), old_faces.end()), old_faces.end());
+		for (auto face : old_faces)
+			eraseFace(face);
+
+		return new_edges.size() / 2;
 	}
 
 	template<class type, size_t dim>
@@ -674,18 +997,58 @@ namespace jmk {
 
 		// Delete all edges
 		for (auto edge : edge_list) {
-			delete edge; // Assuming edge_list holds pointers to EdgeDCEL
+			delete edge; // Empty slots hold nullptr, which is fine to delete
 		}
 		edge_list.clear(); // Clear the edge list
+		free_edge_slots.clear();
 
 		// Delete all faces
 		for (auto face : face_list) {
-			delete face; // Assuming face_list holds pointers to FaceDCEL
+			delete face; // Empty slots hold nullptr, which is fine to delete
 		}
 		face_list.clear(); // Clear the face list
+		free_face_slots.clear();
+
+		vertex_hash.clear();
 	}
 
 	
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::unlinkEdge(EdgeDCEL<type, dim>* edge)
+	{
+		auto twin = edge->twin;
+
+		// Going around each face, the edge before the removed one now continues with the edge after
+		// its twin
+		edge->prev->next = twin->next;
+		twin->next->prev = edge->prev;
+		twin->prev->next = edge->next;
+		edge->next->prev = twin->prev;
+
+		// twin->next leaves the origin of edge and edge->next leaves the origin of twin
+		if (edge->origin->incident_edge == edge)
+			edge->origin->incident_edge = twin->next;
+		if (twin->origin->incident_edge == twin)
+			twin->origin->incident_edge = edge->next;
+	}
+
+	template<class type, size_t dim>
+	inline bool PolygonDCEL<type, dim>::join(VertexDCEL<type, dim>* _v1, VertexDCEL<type, dim>* _v2)
+	{
+		if (!_v1 || !_v2 || !_v1->incident_edge)
+			return false;
+
+		// Find the edge _v1 -> _v2 in the star of _v1
+		auto edge = _v1->incident_edge;
+		do {
+			if (edge->twin->origin == _v2)
+				return join(edge, edge->twin);
+			edge = edge->twin->next;
+		} while (edge != _v1->incident_edge);
+
+		return false;
+	}
+
 	template<class type, size_t dim>
 	inline bool PolygonDCEL<type, dim>::join(EdgeDCEL<type, dim>* edge1, EdgeDCEL<type, dim>* edge2)
 	{
@@ -696,89 +1059,111 @@ namespace jmk {
 			return false;
 		}
 
-		// Ensure edge1 and edge2 meet at a vertex
-		if (edge1->origin != edge2->twin->origin || edge1->twin->origin != edge2->origin)
+		// Ensure edge1 and edge2 are the two halves of the same edge
+		if (edge1->twin != edge2)
 		{
 			std::cerr << "Edges cannot be joined; they do not meet at a common vertex.\n";
 			return false;
 		}
 
-		// Debugging: Print edge information before joining
-		std::cout << "Joining edges: " << edge1->id << " and " << edge2->id << std::endl;
-
-		// Remove edge1 and edge2 from the edge list
-		edge_list.erase(std::remove(edge_list.begin(), edge_list.end(), edge1), edge_list.end());
-		edge_list.erase(std::remove(edge_list.begin(), edge_list.end(), edge2), edge_list.end());
-
-		// Optionally, you can delete edge1 and edge2 from memory if they are dynamically allocated
-		delete edge1;
-		delete edge2;
-
-		// Set the prev and next for the element middle of the list ( 2 : size- 2)
-		for (size_t i = 2; i <= edge_list.size() - 3; i++) {
-
-			if (i % 2 == 0) // Even case. Counter clockwise edges
-			{
-				edge_list[i]->next = edge_list[i + 2];
-				edge_list[i]->prev = edge_list[i - 2];
-			}
-			else           // Odd case. Clockwise edges
-			{
-				edge_list[i]->next = edge_list[i - 2];
-				edge_list[i]->prev = edge_list[i + 2];
-			}
+		// The polygon boundary stays, only diagonals can be removed
+		if (!edge1->incident_face->outer || !edge2->incident_face->outer)
+		{
+			std::cerr << "Edges on the unbounded face cannot be joined.\n";
+			return false;
 		}
 
-		// First to edges
-		edge_list[0]->next = edge_list[2];
-		edge_list[0]->prev = edge_list[edge_list.size() - 2];
-		edge_list[1]->next = edge_list[edge_list.size() - 1];
-		edge_list[1]->prev = edge_list[3];
-
-		// Last twoo edges
-		edge_list[edge_list.size() - 2]->next = edge_list[0];
-		edge_list[edge_list.size() - 2]->prev = edge_list[edge_list.size() - 4];
-		edge_list[edge_list.size() - 1]->next = edge_list[edge_list.size() - 3];
-		edge_list[edge_list.size() - 1]->prev = edge_list[1];
-
-		// Delete all faces
-		for (auto face : face_list) {
-			delete face; // Assuming face_list holds pointers to FaceDCEL
+		// Walk both faces together to find the smaller one, which is the only one relabelled
+		auto walk1 = edge1->next, walk2 = edge2->next;
+		while (walk1 != edge1 && walk2 != edge2)
+		{
+			walk1 = walk1->next;
+			walk2 = walk2->next;
 		}
-		face_list.clear(); // Clear the face list
+		auto dropped_edge = walk1 == edge1 ? edge1 : edge2;
+		auto kept_edge = dropped_edge->twin;
+		FaceDCEL<type, dim>* kept_face = kept_edge->incident_face;
+		FaceDCEL<type, dim>* dropped_face = dropped_edge->incident_face;
 
-		// Configure the faces.
-		FaceDCEL<type, dim>* f1 = new FaceDCEL<type, dim>();
-		FaceDCEL<type, dim>* f2 = new FaceDCEL<type, dim>();
+		for (auto edge = dropped_edge->next; edge != dropped_edge; edge = edge->next)
+			edge->incident_face = kept_face;
+		if (kept_face->outer == kept_edge)
+			kept_face->outer = kept_edge->next;
 
-		f1->outer = edge_list[0];
+		unlinkEdge(edge1);
+		eraseEdge(edge1);
+		eraseEdge(edge2);
+		eraseFace(dropped_face);
 
-		// f2 is the unbounded face which wraps f1. So f1 is a hole in f2. 
-		// f1 has counter-clockwise edges, while f2 has clockwise edges.
+		return true;
+	}
 
-		f2->inner.push_back(edge_list[1]);
+	template<class type, size_t dim>
+	inline size_t PolygonDCEL<type, dim>::joinMany(const std::vector<EdgeDCEL<type, dim>*>& _edges)
+	{
+		typedef EdgeDCEL<type, dim> Edge;
+		typedef FaceDCEL<type, dim> Face;
+
+		// Keep one half of every diagonal
+		std::vector<Edge*> edges;
+		edges.reserve(_edges.size());
+		for (auto edge : _edges)
+			if (edge && edge->incident_face->outer && edge->twin->incident_face->outer)
+				edges.push_back(edge->id < edge->twin->id ? edge : edge->twin);
+		std::sort(edges.begin(), edges.end(), [](Edge* a, Edge* b) { return a->id < b->id; });
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		// The removed edges lose their face first, so they can be told apart from the ones that stay
+		std::vector<Face*> touched;
+		touched.reserve(2 * edges.size());
+		for (auto edge : edges)
+		{
+			touched.push_back(edge->incident_face);
+			touched.push_back(edge->twin->incident_face);
+			edge->incident_face = nullptr;
+			edge->twin->incident_face = nullptr;
+		}
 
-		face_list.push_back(f1);
-		face_list.push_back(f2);
+		// Splice them out one by one. The neighbours of the last edge removed from a merged face all
+		// stay, so among the neighbours there is a start edge for every merged face.
+		std::vector<Edge*> starts;
+		starts.reserve(2 * edges.size());
+		for (auto edge : edges)
+		{
+			starts.push_back(edge->prev);
+			starts.push_back(edge->twin->prev);
+			unlinkEdge(edge);
+		}
 
-		f1->outer->incident_face = f1;
-		EdgeDCEL<type, dim>* edge = f1->outer->next;
-		while (edge != f1->outer)
+		// Relabel every merged face after one of the old faces in it. All the edges of an old face end
+		// up in the same merged face, so a start edge whose face is already kept has been walked.
+		visit_mark += 2;
+		const size_t kept = visit_mark;
+		for (auto start : starts)
 		{
-			edge->incident_face = f1;
-			edge = edge->next;
+			Face* face = start->incident_face;
+			if (!face || face->visit == kept)
+				continue;
+
+			face->visit = kept;
+			face->outer = start;
+			for (auto edge = start->next; edge != start; edge = edge->next)
+				edge->incident_face = face;
 		}
 
-		// f2->inner has halfedges connect in clockwise order
-		f2->inner[0]->incident_face = f2;
-		edge = f2->inner[0]->next;
-		while (edge != f2->inner[0])
+		std::sort(touched.begin(), touched.end(), [](Face* a, Face* b) { return a->slot < b->slot; });
+		touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+		for (auto face : touched)
+			if (face->visit != kept)
+				eraseFace(face);
+
+		for (auto edge : edges)
 		{
-			edge->incident_face = f2;
-			edge = edge->next;
+			eraseEdge(edge->twin);
+			eraseEdge(edge);
 		}
 
-		return true;
+		return edges.size();
 	}
 
 	template<class type, size_t dim>
@@ -791,20 +1176,36 @@ namespace jmk {
 	template<class type, size_t dim>
 	inline std::vector<FaceDCEL<type, dim>*> PolygonDCEL<type, dim>::getFaceList()
 	{
-		// Return the list of faces in the DCEL.
-		return face_list;
+		// Return the list of faces in the DCEL, without the empty slots.
+		std::vector<FaceDCEL<type, dim>*> faces;
+		faces.reserve(face_list.size() - free_face_slots.size());
+		for (auto face : face_list)
+			if (face)
+				faces.push_back(face);
+		return faces;
 	}
 
 	template<class type, size_t dim>
 	inline std::vector<EdgeDCEL<type, dim>*> PolygonDCEL<type, dim>::getEdgeList()
 	{
-		// Return the list of edges in the DCEL.
-		return edge_list;
+		// Return the list of edges in the DCEL, without the empty slots.
+		std::vector<EdgeDCEL<type, dim>*> edges;
+		edges.reserve(edge_list.size() - free_edge_slots.size());
+		for (auto edge : edge_list)
+			if (edge)
+				edges.push_back(edge);
+		return edges;
 	}
 
 	template<class type, size_t dim>
-	inline VertexDCEL<type, dim>* PolygonDCEL<type, dim>::getVertex(VectorNf& _point)
+	inline VertexDCEL<type, dim>* PolygonDCEL<type, dim>::getVertex(const VectorNf& _point)
 	{
+		if (hash_vertices)
+		{
+			uint32_t index = vertex_hash.find(_point, [this](uint32_t i) -> const VectorNf& { return vertex_list[i]->point; });
+			return index == POINT_HASH_NOT_FOUND ? nullptr : vertex_list[index];
+		}
+
 		// Find a vertex with the given coordinates (point).
 		for (size_t i = 0; i < vertex_list.size(); i++) 
 		{
@@ -814,14 +1215,47 @@ namespace jmk {
 		return nullptr; // If no match is found, return nullptr.
 	}
 
+	template<class type, size_t dim>
+	inline std::vector<VertexDCEL<type, dim>*> PolygonDCEL<type, dim>::getVertices(const std::vector<VectorNf>& _points)
+	{
+		bool temporary = !hash_vertices;
+		if (temporary)
+			setVertexHash(true);
+
+		std::vector<VertexDCEL<type, dim>*> vertices(_points.size());
+		for (size_t i = 0; i < _points.size(); i++)
+			vertices[i] = getVertex(_points[i]);
+
+		if (temporary)
+			setVertexHash(false);
+		return vertices;
+	}
+
+	template<class type, size_t dim>
+	inline void PolygonDCEL<type, dim>::setVertexHash(bool _enabled)
+	{
+		vertex_hash.clear();
+		hash_vertices = _enabled;
+		if (!_enabled)
+			return;
+
+		vertex_hash.reserve(vertex_list.size());
+		for (size_t i = 0; i < vertex_list.size(); i++)
+			vertex_hash.insert(vertex_list[i]->point, (uint32_t)i);
+	}
+
 	struct Vertex2DSortTBLR {
 		// Custom comparator to sort 2D vertices.
 		// Sort by top-to-bottom, left-to-right (TBLR).
-		bool operator()(Vertex2dDCEL* ref1, Vertex2dDCEL* ref2)
+		template<class type>
+		bool operator()(const VertexDCEL<type, 2>* ref1, const VertexDCEL<type, 2>* ref2) const
 		{
-			auto a = ref1->point;
-			auto b = ref2->point;
+			return (*this)(ref1->point, ref2->point);
+		}
 
+		template<class type>
+		bool operator()(const Vector<type, 2>& a, const Vector<type, 2>& b) const
+		{
 			// First compare by Y-coordinate (top to bottom).
 			// If Y is the same, compare by X-coordinate (left to right).
 			if ((a[Y] > b[Y]) || (a[Y] == b[Y] && (a[X] < b[X])))
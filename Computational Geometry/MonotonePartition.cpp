@@ -1,8 +1,13 @@
 #include "MonotonePartition.h"
 
-#include <set>
-#include <map>
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "Core\Predicates.h"
+#include "Core\Base\SweepStatus.h"
+#include "Core\Base\EventQueue.h"
+#include "Core\Base\Parallel.h"
 
 using namespace jmk;
 
@@ -15,29 +20,33 @@ enum class VERTEX_CATEGORY {
 	INVALID
 };
 
-VERTEX_CATEGORY categorize_vertex(Vertex2dDCEL* vertex)
-{
-	Vertex2dDCEL* v_prev = vertex->incident_edge->prev->origin;
-	Vertex2dDCEL* v_next = vertex->incident_edge->next->origin;
+// The sweep is written against the handle accessors shared by PolygonDCEL and ArenaPolygonDCEL
+// (point, incidentEdge, next, prev, ...), so it runs on either backend.
 
-	// Need vertex beside the given one to get the decision. Return INVALID if one is missing
-	if (!v_prev || !v_next)
-		return VERTEX_CATEGORY::INVALID;
+// Vertices are compared in the event queue order, Vertex2DSortTBLR: on equal y the left one counts as
+// higher. The categories have to use the same order, or a vertex on a horizontal edge is seen as
+// regular by one and as a start / end by the other.
+template<class DCEL>
+VERTEX_CATEGORY categorize_vertex(const DCEL& dcel, typename DCEL::VertexHandle vertex)
+{
+	typedef typename DCEL::coordinate_type type;
 
-	Point2d p_prev = v_prev->point;
-	Point2d p = vertex->point;
-	Point2d p_next = v_next->point;
+	auto edge = dcel.incidentEdge(vertex);
+	Vector<type, DIM2> p_prev = dcel.point(dcel.origin(dcel.prev(edge)));
+	Vector<type, DIM2> p = dcel.point(vertex);
+	Vector<type, DIM2> p_next = dcel.point(dcel.origin(dcel.next(edge)));
 
 	bool is_left = left(p_prev, p, p_next);
 
-	if (p[Y] > p_prev[Y] && p[Y] > p_next[Y])
+	Vertex2DSortTBLR above;
+	if (above(p, p_prev) && above(p, p_next))
 	{
 		if (is_left)
 			return VERTEX_CATEGORY::START;
 		else
 			return VERTEX_CATEGORY::SPLIT;
 	}
-	else if (p[Y] < p_prev[Y] && p[Y] < p_next[Y])
+	else if (above(p_prev, p) && above(p_next, p))
 	{
 		if (is_left)
 			return VERTEX_CATEGORY::END;
@@ -50,123 +59,238 @@ VERTEX_CATEGORY categorize_vertex(Vertex2dDCEL* vertex)
 	}
 }
 
+template<class DCEL>
 struct Vertex2dDCELWrapper 
 {
-	Vertex2dDCEL* vert;
+	typename DCEL::VertexHandle vert;
 	VERTEX_CATEGORY category;
 };
 
+// Bound on the difference of two edge x values interpolated in double from int32 coordinates. Each
+// is off by less than 2^-19, the sum of the rounding in dx / dy, in the product with at most 2^32 and
+// in adding the origin x.
+#define SWEEP_INTERPOLATION_ERROR (1.0 / (1 << 16))
+
+template<class DCEL>
 struct Edge2dDCELWrapper 
 {
-	Edge2dDCEL* edge;
-	Vertex2dDCELWrapper helper;
+	typedef typename DCEL::coordinate_type type;
+
+	typename DCEL::EdgeHandle edge;
+	Vertex2dDCELWrapper<DCEL> helper;
 
-	Edge2dDCELWrapper(Edge2dDCEL* _edge, Vertex2dDCELWrapper& _helper) 
+	Edge2dDCELWrapper() {}
+
+	Edge2dDCELWrapper(const DCEL& dcel, typename DCEL::EdgeHandle _edge, Vertex2dDCELWrapper<DCEL>& _helper) 
 	{
 		edge = _edge;
 		helper = _helper;
-		orgin = edge->origin->point;
-		dest = edge->twin->origin->point;
+
+		// The slope is taken once here, the sweep comparator calls computeX O(log n) times per event
+		const auto& orgin = dcel.point(dcel.origin(edge));
+		const auto& dest = dcel.point(dcel.destination(edge));
+		origin_x = orgin[X];
+		origin_y = orgin[Y];
+		horizontal = (real_t<type>)dest[Y] - orgin[Y] == 0;
+		if (!horizontal)
+			dx_dy = ((real_t<type>)dest[X] - orgin[X]) / ((real_t<type>)dest[Y] - orgin[Y]);
+
+		lower = orgin[Y] < dest[Y] ? orgin : dest;
+		upper = orgin[Y] < dest[Y] ? dest : orgin;
+	}
+
+	// Integer coordinates are interpolated in double, floating point ones in their own precision
+	const real_t<type> computeX(const Vector<type, DIM2>& point) const
+	{
+		if (horizontal)
+			return point[X];
+		return ((real_t<type>)point[Y] - origin_y) * dx_dy + origin_x;
 	}
 
-	const float computeX(const Point2d& point) const
+	// Sign of the x of this edge minus the x of other, on the horizontal line through point. Integer
+	// coordinates fall back to the exact predicates when the interpolated values are too close to tell.
+	int compareX(const Edge2dDCELWrapper& other, const Vector<type, DIM2>& point) const
 	{
-		float _deno = (dest[Y] - orgin[Y]);
-		float _x = point[X];
-		if (_deno != 0) {
-			_x = (point[Y] - orgin[Y]) * (dest[X] - orgin[X]) / _deno + orgin[X];
+		real_t<type> x = computeX(point), other_x = other.computeX(point);
+		if constexpr (std::is_integral<type>::value)
+		{
+			if (std::fabs(x - other_x) <= SWEEP_INTERPOLATION_ERROR)
+				return compareXExact(other, point);
 		}
-		return _x;
+		return x < other_x ? -1 : (other_x < x ? 1 : 0);
 	}
 
 	private:
-		Point2d orgin, dest;
-};
-
-struct Vertex2DWrapperSort 
-{
-	bool operator()(Vertex2dDCELWrapper& current, Vertex2dDCELWrapper& ref)
-	{
-		auto cur_pnt = current.vert->point;
-		auto ref_pnt = ref.vert->point;
-		if ((cur_pnt[Y] > ref_pnt[Y])
-			|| (cur_pnt[Y] == ref_pnt[Y]) && (cur_pnt[X] < ref_pnt[X]))
+		real_t<type> origin_x = 0, origin_y = 0;
+		real_t<type> dx_dy = 0;       // Inverse slope of the edge
+		bool horizontal = false;
+		Vector<type, DIM2> lower, upper;
+
+		// The x on the sweep line is exact when an end point lies on it. A horizontal edge is on the
+		// sweep line only while the sweep is at its own y, then it counts as being at point.
+		bool exactX(const Vector<type, DIM2>& point, type& x) const
 		{
+			if (horizontal)
+				x = point[X];
+			else if (lower[Y] == point[Y])
+				x = lower[X];
+			else if (upper[Y] == point[Y])
+				x = upper[X];
+			else
+				return false;
 			return true;
 		}
-		return false;
-	}
+
+		// Sign of q's x minus the x of this edge at q's y, q must be within the edge's y range
+		int side(const Vector<type, DIM2>& q) const
+		{
+			return -orient2d(lower, upper, q);
+		}
+
+		// The edges of a simple polygon do not cross, so when neither has an end point on the sweep
+		// line, their order there is the side of an end point of one against the other edge, taken
+		// where their y ranges overlap.
+		int compareXExact(const Edge2dDCELWrapper& other, const Vector<type, DIM2>& point) const
+		{
+			type x, other_x;
+			bool known = exactX(point, x), other_known = other.exactX(point, other_x);
+			if (known && other_known)
+				return x < other_x ? -1 : (other_x < x ? 1 : 0);
+			if (known)
+				return other.side(Vector<type, DIM2>(x, point[Y]));
+			if (other_known)
+				return -side(Vector<type, DIM2>(other_x, point[Y]));
+
+			int s = upper[Y] <= other.upper[Y] ? other.side(upper) : -side(other.upper);
+			if (s != 0)
+				return s;
+			return lower[Y] >= other.lower[Y] ? other.side(lower) : -side(other.lower);
+		}
 };
 
+template<class DCEL>
 struct SweepLineComparator 
 {
-	Point2d* point;
-	SweepLineComparator(Point2d* _point) {
+	typedef typename DCEL::coordinate_type type;
+
+	const Vector<type, DIM2>* point;
+	SweepLineComparator(const Vector<type, DIM2>* _point) {
 		point = _point;
 	}
 
-	bool operator()(const Edge2dDCELWrapper* _ref1, const Edge2dDCELWrapper* _ref2) const {
-		return _ref1->computeX(*point) < _ref2->computeX(*point);
+	bool operator()(const Edge2dDCELWrapper<DCEL>* _ref1, const Edge2dDCELWrapper<DCEL>* _ref2) const {
+		return _ref1->compareX(*_ref2, *point) < 0;
+	}
+};
+
+template<class DCEL>
+using SweepLine = SweepStatus<Edge2dDCELWrapper<DCEL>*, SweepLineComparator<DCEL>>;
+
+// Every edge in the sweep line is the boundary edge leaving some vertex, so the wrappers live in one
+// flat table indexed by that vertex's index. The table is allocated once per call and doubles as the
+// arena the sweep line points in to, so the handlers never allocate.
+template<class DCEL>
+struct EdgeMapper
+{
+	const DCEL& dcel;
+	Edge2dDCELWrapper<DCEL>* wrappers;
+
+	// Slab sweeps only (see partition_monotone_slabs). The edges inserted above the slab, before
+	// first_event, have their own copies in seeds, at seed_slot[index of their origin].
+	const uint32_t* rank = nullptr;         // Event number of each vertex, by index
+	uint32_t first_event = 0;
+	Edge2dDCELWrapper<DCEL>* seeds = nullptr;
+	const uint32_t* seed_slot = nullptr;
+
+	EdgeMapper(const DCEL& _dcel, Edge2dDCELWrapper<DCEL>* _wrappers) : dcel(_dcel), wrappers(_wrappers) {}
+
+	// Wrapper of the edge leaving vertex.vert, with vertex as its helper
+	Edge2dDCELWrapper<DCEL>* create(Vertex2dDCELWrapper<DCEL>& vertex)
+	{
+		auto& wrapper = wrappers[dcel.index(vertex.vert)];
+		wrapper = Edge2dDCELWrapper<DCEL>(dcel, dcel.incidentEdge(vertex.vert), vertex);
+		return &wrapper;
+	}
+
+	// Wrapper of the boundary edge, which must have been created
+	Edge2dDCELWrapper<DCEL>* operator[](typename DCEL::EdgeHandle edge)
+	{
+		uint32_t i = dcel.index(dcel.origin(edge));
+		if (seeds && rank[i] < first_event)
+			return &seeds[seed_slot[i]];
+		return &wrappers[i];
+	}
+};
+
+// The handlers only collect the diagonals, they are inserted in one go once the sweep is done.
+// A slab sweep does not know the helpers of the edges that reach in to its slab from above, until
+// the slabs above are done. Such a helper is marked INVALID and holds the origin of its edge, the
+// diagonals to it are kept as pending and resolved when the slabs are stitched.
+template<class DCEL>
+struct Diagonals
+{
+	std::vector<std::pair<typename DCEL::VertexHandle, typename DCEL::VertexHandle>> list;
+	std::vector<std::pair<uint32_t, bool>> pending;     // Position in list, only if the helper is a merge vertex
+
+	// Diagonal from vertex to helper, always or only when the helper is a merge vertex
+	void connect(const Vertex2dDCELWrapper<DCEL>& vertex, const Vertex2dDCELWrapper<DCEL>& helper, bool merge_only)
+	{
+		if (helper.category == VERTEX_CATEGORY::INVALID)
+			pending.push_back({ (uint32_t)list.size(), merge_only });
+		else if (merge_only && helper.category != VERTEX_CATEGORY::MERGE)
+			return;
+		list.push_back({ vertex.vert, helper.vert });
 	}
 };
 
+// Regular vertex with the polygon interior to its right. Its edge takes the place of its previous
+// edge in the sweep line.
+template<class DCEL>
+static bool is_regular_left(const DCEL& dcel, typename DCEL::VertexHandle vertex)
+{
+	auto incident_edge = dcel.incidentEdge(vertex);
+	Vertex2DSortTBLR above;
+	return above(dcel.point(dcel.origin(dcel.prev(incident_edge))), dcel.point(vertex))
+		&& above(dcel.point(vertex), dcel.point(dcel.origin(dcel.next(incident_edge))));
+}
+
 // TODO : Check the posibility of Refactoring the code to remove duplicate lines
 
-static void handle_start_vertices(Vertex2dDCELWrapper& vertex
-	, std::set<Edge2dDCELWrapper*, SweepLineComparator>& sweep_line
-	, std::map<Edge2dDCEL*, Edge2dDCELWrapper*>& edge_mapper, Polygon2d* poly)
+template<class DCEL>
+static void handle_start_vertices(const DCEL& /*dcel*/, Vertex2dDCELWrapper<DCEL>& vertex
+	, SweepLine<DCEL>& sweep_line, EdgeMapper<DCEL>& edge_mapper, Diagonals<DCEL>& /*diagonals*/)
 {
-	Edge2dDCELWrapper* edge = new Edge2dDCELWrapper(vertex.vert->incident_edge, vertex);
-	sweep_line.insert(edge);
-	edge_mapper.insert(std::pair<Edge2dDCEL*, Edge2dDCELWrapper*>(vertex.vert->incident_edge, edge));
+	sweep_line.insert(edge_mapper.create(vertex));
 }
 
-static void handle_end_vertices(Vertex2dDCELWrapper& vertex
-	, std::set<Edge2dDCELWrapper*, SweepLineComparator>& sweep_line
-	, std::map<Edge2dDCEL*, Edge2dDCELWrapper*>& edge_mapper, Polygon2d* poly)
+template<class DCEL>
+static void handle_end_vertices(const DCEL& dcel, Vertex2dDCELWrapper<DCEL>& vertex
+	, SweepLine<DCEL>& sweep_line, EdgeMapper<DCEL>& edge_mapper, Diagonals<DCEL>& diagonals)
 {
-	auto edge_wrapper = edge_mapper[vertex.vert->incident_edge->prev];
+	auto edge_wrapper = edge_mapper[dcel.prev(dcel.incidentEdge(vertex.vert))];
 	auto found = sweep_line.find(edge_wrapper);
-	auto helper = (*found)->helper;
-	if (helper.category == VERTEX_CATEGORY::MERGE)
-		poly->split(vertex.vert, helper.vert);
+	if (found == sweep_line.end())
+		return;
+	diagonals.connect(vertex, (*found)->helper, true);
 	sweep_line.erase(found);
 }
 
 // Function to handle "split" vertices in polygon processing
-static void handle_split_vertices(Vertex2dDCELWrapper& vertex,
-	std::set<Edge2dDCELWrapper*, SweepLineComparator>& sweep_line,
-	std::map<Edge2dDCEL*, Edge2dDCELWrapper*>& edge_mapper,	Polygon2d* poly)
+template<class DCEL>
+static void handle_split_vertices(const DCEL& /*dcel*/, Vertex2dDCELWrapper<DCEL>& vertex,
+	SweepLine<DCEL>& sweep_line, EdgeMapper<DCEL>& edge_mapper, Diagonals<DCEL>& diagonals)
 {
 	// Create an edge wrapper for the current vertex's incident edge
-	Edge2dDCELWrapper* edge = new Edge2dDCELWrapper(vertex.vert->incident_edge, vertex);
-
-	// Locate where this new edge would be positioned in the sweep line using lower_bound
-	auto found = sweep_line.lower_bound(edge);
-	Edge2dDCELWrapper* ej;
-
-	// If lower_bound points to the end of the sweep line (meaning no greater edge exists)
-	if (found == sweep_line.end()) {
-		// Check if the sweep line has any elements to process
-		if (sweep_line.size() > 0) {
-			// Move iterator to the last element in sweep line
-			ej = *(--found);
+	Edge2dDCELWrapper<DCEL>* edge = edge_mapper.create(vertex);
 
-			// Perform a polygon split between the current vertex and the helper vertex of the last edge
-			poly->split(vertex.vert, ej->helper.vert);
-
-			// Update the helper of this last edge to the current vertex
-			ej->helper = vertex;
-		}
-	}
-	// If found is not at the beginning, process the previous edge in the sweep line
-	else if (found != sweep_line.begin())
+	// Find the edge directly to the left of the vertex in the sweep line
+	auto found = sweep_line.predecessor(edge);
+	if (found != sweep_line.end())
 	{
-		// Move 'found' to the previous edge in the sweep line
-		ej = *(--found);
+		Edge2dDCELWrapper<DCEL>* ej = *found;
 
-		// Perform a polygon split between the current vertex and the helper vertex of this edge
-		poly->split(vertex.vert, ej->helper.vert);
+		// Add a diagonal between the current vertex and the helper vertex of this edge
+		diagonals.connect(vertex, ej->helper, false);
 
 		// Update the helper of this edge to the current vertex
 		ej->helper = vertex;
@@ -174,26 +298,20 @@ static void handle_split_vertices(Vertex2dDCELWrapper& vertex,
 
 	// Insert the newly created edge into the sweep line
 	sweep_line.insert(edge);
-
-	// Update the edge_mapper to associate this edge with its corresponding DCEL edge
-	edge_mapper.insert(std::pair<Edge2dDCEL*, Edge2dDCELWrapper*>(vertex.vert->incident_edge, edge));
 }
 
 // Function to handle merge vertices in a DCEL (Doubly Connected Edge List) structure,
 // ensuring the polygon's geometry is updated if needed.
-static void handle_merge_vertices(Vertex2dDCELWrapper& vertex,
-	std::set<Edge2dDCELWrapper*, SweepLineComparator>& sweep_line,
-	std::map<Edge2dDCEL*, Edge2dDCELWrapper*>& edge_mapper,
-	Polygon2d* poly)
+template<class DCEL>
+static void handle_merge_vertices(const DCEL& dcel, Vertex2dDCELWrapper<DCEL>& vertex,
+	SweepLine<DCEL>& sweep_line, EdgeMapper<DCEL>& edge_mapper, Diagonals<DCEL>& diagonals)
 {
 	// Retrieve the edge wrapping the previous edge of the current vertex
-	auto edge_wrapper = edge_mapper[vertex.vert->incident_edge->prev];
+	auto edge_wrapper = edge_mapper[dcel.prev(dcel.incidentEdge(vertex.vert))];
 
-	// Check if the helper of this previous edge is a merge vertex
-	if (edge_wrapper->helper.category == VERTEX_CATEGORY::MERGE) {
-		// If so, perform a polygon split at the current vertex and helper vertex
-		poly->split(vertex.vert, edge_wrapper->helper.vert);
-	}
+	// If the helper of this previous edge is a merge vertex, add a diagonal between the current
+	// vertex and helper vertex
+	diagonals.connect(vertex, edge_wrapper->helper, true);
 
 	// Attempt to locate 'edge_wrapper' in the sweep line set
 	auto found = sweep_line.find(edge_wrapper);
@@ -203,40 +321,18 @@ static void handle_merge_vertices(Vertex2dDCELWrapper& vertex,
 		// Remove 'edge_wrapper' from the sweep line
 		sweep_line.erase(found);
 
-	// Create a new edge wrapper for the current vertex's incident edge
-	Edge2dDCELWrapper* edge = new Edge2dDCELWrapper(vertex.vert->incident_edge, vertex);
-
-	// Find the appropriate position of 'edge' in the sweep line based on x-order
-	found = sweep_line.lower_bound(edge);
-
-	Edge2dDCELWrapper* ej;
+	// Wrap the current vertex's incident edge, it is only used to search the sweep line
+	Edge2dDCELWrapper<DCEL> edge(dcel, dcel.incidentEdge(vertex.vert), vertex);
 
-	// If 'found' reaches the end of the sweep line (meaning no elements were greater),
-	// we will need to check the last element in the sweep line.
-	if (found == sweep_line.end()) {
-		// Confirm that there is at least one element in the sweep line
-		if (sweep_line.size() > 0) {
-			// Move 'found' to point to the last element in the sweep line
-			ej = *(--found);
-
-			// Check if the helper of this last edge is a merge vertex
-			if (ej->helper.category == VERTEX_CATEGORY::MERGE)
-				// Perform a split at the current vertex and helper vertex if true
-				poly->split(vertex.vert, ej->helper.vert);
-
-			// Update the helper of this last edge to the current vertex
-			ej->helper = vertex;
-		}
-	}
-	// If 'found' is not the first element in the sweep line (ensures we can check a previous edge)
-	else if (found != sweep_line.begin()) {
-		// Move 'found' back to the previous element in the sweep line
-		ej = *(--found);
+	// Find the edge directly to the left of the vertex in the sweep line
+	found = sweep_line.predecessor(&edge);
+	if (found != sweep_line.end())
+	{
+		Edge2dDCELWrapper<DCEL>* ej = *found;
 
-		// If the previous edge's helper is a merge vertex
-		if (ej->helper.category == VERTEX_CATEGORY::MERGE)
-			// Perform a split at the current vertex and helper vertex
-			poly->split(vertex.vert, ej->helper.vert);
+		// If the previous edge's helper is a merge vertex, add a diagonal between the current vertex
+		// and helper vertex
+		diagonals.connect(vertex, ej->helper, true);
 
 		// Update the helper of this previous edge to the current vertex
 		ej->helper = vertex;
@@ -244,70 +340,43 @@ static void handle_merge_vertices(Vertex2dDCELWrapper& vertex,
 }
 
 // Function to handle regular (non-special) vertices in polygon processing
-static void handle_regular_vertices(Vertex2dDCELWrapper& vertex,
-	std::set<Edge2dDCELWrapper*, SweepLineComparator>& sweep_line,
-	std::map<Edge2dDCEL*, Edge2dDCELWrapper*>& edge_mapper,
-	Polygon2d* poly)
+template<class DCEL>
+static void handle_regular_vertices(const DCEL& dcel, Vertex2dDCELWrapper<DCEL>& vertex,
+	SweepLine<DCEL>& sweep_line, EdgeMapper<DCEL>& edge_mapper, Diagonals<DCEL>& diagonals)
 {
-	// Determine if the polygon interior is to the right of the vertex
-	auto prev_y = vertex.vert->incident_edge->prev->origin->point[Y];
-	auto current_y = vertex.vert->point[Y];
-	auto next_y = vertex.vert->incident_edge->next->origin->point[Y];
-
-	// Create an edge wrapper for the current vertex's incident edge
-	Edge2dDCELWrapper* edge = new Edge2dDCELWrapper(vertex.vert->incident_edge, vertex);
+	auto incident_edge = dcel.incidentEdge(vertex.vert);
 
 	// Check if the vertex is a 'regular left vertex' (i.e., polygon interior is on the right)
-	if (prev_y >= current_y && current_y >= next_y)
+	if (is_regular_left(dcel, vertex.vert))
 	{
 		// Retrieve the edge wrapper for the previous edge of the current vertex
-		auto edge_wrapper = edge_mapper[vertex.vert->incident_edge->prev];
+		auto edge_wrapper = edge_mapper[dcel.prev(incident_edge)];
 
 		// If the helper of this previous edge is a 'MERGE' vertex, split the polygon
-		if (edge_wrapper->helper.category == VERTEX_CATEGORY::MERGE)
-		{
-			poly->split(vertex.vert, edge_wrapper->helper.vert);
-		}
+		diagonals.connect(vertex, edge_wrapper->helper, true);
 
 		// Locate and remove 'edge_wrapper' from the sweep line if it exists
 		auto found = sweep_line.find(edge_wrapper);
 		if (found != sweep_line.end())
 			sweep_line.erase(found);
 
-		// Insert the new edge into the sweep line and update edge_mapper with this edge
-		sweep_line.insert(edge);
-		edge_mapper.insert(std::pair<Edge2dDCEL*, Edge2dDCELWrapper*>(vertex.vert->incident_edge, edge));
+		// Insert the wrapper of the current vertex's incident edge into the sweep line
+		sweep_line.insert(edge_mapper.create(vertex));
 	}
 	else
 	{
-		// For vertices where the polygon interior is to the left
-		auto found = sweep_line.lower_bound(edge);
-		Edge2dDCELWrapper* ej;
-
-		// If found is at the end of sweep_line, check the last element in sweep_line
-		if (found == sweep_line.end()) {
-			// Ensure there are elements in sweep_line to check
-			if (sweep_line.size() > 0) {
-				// Move to the last element in sweep_line
-				ej = *(--found);
-
-				// If the last edge's helper is a 'MERGE' vertex, split the polygon
-				if (ej->helper.category == VERTEX_CATEGORY::MERGE)
-					poly->split(vertex.vert, ej->helper.vert);
-
-				// Update the helper of the last edge to the current vertex
-				ej->helper = vertex;
-			}
-		}
-		// If found is not the beginning of sweep_line, check the previous edge
-		else if (found != sweep_line.begin())
+		// For vertices where the polygon interior is to the left. The incident edge is only
+		// wrapped to search the sweep line
+		Edge2dDCELWrapper<DCEL> edge(dcel, incident_edge, vertex);
+
+		// Find the edge directly to the left of the vertex in the sweep line
+		auto found = sweep_line.predecessor(&edge);
+		if (found != sweep_line.end())
 		{
-			// Move 'found' to the previous edge in the sweep line
-			ej = *(found--);
+			Edge2dDCELWrapper<DCEL>* ej = *found;
 
 			// If this previous edge's helper is a 'MERGE' vertex, split the polygon
-			if (ej->helper.category == VERTEX_CATEGORY::MERGE)
-				poly->split(vertex.vert, ej->helper.vert);
+			diagonals.connect(vertex, ej->helper, true);
 
 			// Update the helper of this previous edge to the current vertex
 			ej->helper = vertex;
@@ -315,69 +384,309 @@ static void handle_regular_vertices(Vertex2dDCELWrapper& vertex,
 	}
 }
 
-
-void jmk::get_monotone_polygons(Polygon2d* poly, std::vector<Polygon2d*>& mono_polies)
+// Runs the events [begin, end) through the handlers. sweep_point is the point the comparator of
+// sweep_line reads.
+template<class DCEL>
+static void sweep_events(const DCEL& dcel, const std::vector<Vertex2dDCELWrapper<DCEL>>& vertices, size_t begin, size_t end,
+	Vector<typename DCEL::coordinate_type, DIM2>& sweep_point, SweepLine<DCEL>& sweep_line,
+	EdgeMapper<DCEL>& edge_mapping, Diagonals<DCEL>& diagonals)
 {
-	std::vector<Vertex2dDCELWrapper> vertices;
-	for (auto vertex : poly->getVertexList()) {
-		vertices.push_back(Vertex2dDCELWrapper{ vertex,categorize_vertex(vertex) });
-	}
-
-	std::sort(vertices.begin(), vertices.end(), Vertex2DWrapperSort());
-
-	Point2d* sweep_point = new Point2d();
-	sweep_point->assign(X, vertices[0].vert->point[X]);
-	sweep_point->assign(Y, vertices[0].vert->point[Y]);
-
-	SweepLineComparator comp(sweep_point);
-	std::set<Edge2dDCELWrapper*, SweepLineComparator> sweep_line(comp);
-	std::map<Edge2dDCEL*, Edge2dDCELWrapper*> edge_mapping;
-
-	for (auto vertex : vertices)
+	for (size_t i = begin; i < end; i++)
 	{
-		sweep_point->assign(X, vertex.vert->point[X]);
-		sweep_point->assign(Y, vertex.vert->point[Y]);
+		auto vertex = vertices[i];
+		sweep_point = dcel.point(vertex.vert);
 
 		switch (vertex.category)
 		{
 		case VERTEX_CATEGORY::START:
-			handle_start_vertices(vertex, sweep_line, edge_mapping, poly);
+			handle_start_vertices(dcel, vertex, sweep_line, edge_mapping, diagonals);
 			break;
 		case VERTEX_CATEGORY::END:
-			handle_end_vertices(vertex, sweep_line, edge_mapping, poly);
+			handle_end_vertices(dcel, vertex, sweep_line, edge_mapping, diagonals);
 			break;
 		case VERTEX_CATEGORY::REGULAR:
-			handle_regular_vertices(vertex, sweep_line, edge_mapping, poly);
+			handle_regular_vertices(dcel, vertex, sweep_line, edge_mapping, diagonals);
 			break;
 		case VERTEX_CATEGORY::SPLIT:
-			handle_split_vertices(vertex, sweep_line, edge_mapping, poly);
+			handle_split_vertices(dcel, vertex, sweep_line, edge_mapping, diagonals);
 			break;
 		case VERTEX_CATEGORY::MERGE:
-			handle_merge_vertices(vertex, sweep_line, edge_mapping, poly);
+			handle_merge_vertices(dcel, vertex, sweep_line, edge_mapping, diagonals);
 			break;
 		case VERTEX_CATEGORY::INVALID:
 			break;
 		}
 	}
+}
 
-	std::vector<std::vector<Point2d>> polygon_pieces_vertices;
+// One horizontal slab of the parallel sweep
+template<class DCEL>
+struct SweepSlab
+{
+	uint32_t begin = 0, end = 0;                                    // Its events
+	std::vector<typename DCEL::EdgeHandle> seed_edges;              // In the sweep line when the slab starts
+	Diagonals<DCEL> diagonals;
+	std::vector<std::pair<uint32_t, Vertex2dDCELWrapper<DCEL>>> helpers;    // Known at the end, by index of the edge's origin
+};
 
-	for (auto face_ptr : poly->getFaceList()) {
-		auto first_edge_ptr = face_ptr->outer;
-		if (first_edge_ptr) {
-			std::vector<Point2d> vertices;
-			vertices.push_back(first_edge_ptr->origin->point);
+// Parallel version of the sweep. The events are cut in to one slab per thread, only ever between
+// events of different y. Which edges are in the sweep line at the top of a slab only depends on the
+// vertex categories, so each slab starts from its own copy of those edges and the slabs are swept at
+// the same time. What a slab can not know are the helpers of the edges coming from above, the
+// diagonals to those are resolved in a last pass that walks the slabs top to bottom and carries the
+// helpers over. The diagonals are the same, and in the same order, as from the serial sweep.
+template<class DCEL>
+static void partition_monotone_slabs(const DCEL& dcel, const std::vector<Vertex2dDCELWrapper<DCEL>>& vertices,
+	std::vector<Edge2dDCELWrapper<DCEL>>& wrappers, unsigned thread_count, Diagonals<DCEL>& diagonals)
+{
+	typedef typename DCEL::coordinate_type type;
+	typedef Edge2dDCELWrapper<DCEL> Wrapper;
 
-			auto next_edge_ptr = first_edge_ptr->next;
-			while (next_edge_ptr != first_edge_ptr) {
-				vertices.push_back(next_edge_ptr->origin->point);
-				next_edge_ptr = next_edge_ptr->next;
-			}
+	const uint32_t count = (uint32_t)vertices.size();
+	std::vector<uint32_t> rank(count);
+	for (uint32_t i = 0; i < count; i++)
+		rank[dcel.index(vertices[i].vert)] = i;
 
-			polygon_pieces_vertices.push_back(vertices);
+	std::vector<SweepSlab<DCEL>> slabs;
+	std::vector<uint32_t> slab_ends;
+	for (unsigned s = 1; s <= thread_count; s++)
+	{
+		uint32_t begin = slab_ends.empty() ? 0 : slab_ends.back();
+		uint32_t end = (uint32_t)((uint64_t)count * s / thread_count);
+		while (end < count && end > 0 && dcel.point(vertices[end - 1].vert)[Y] == dcel.point(vertices[end].vert)[Y])
+			end++;
+		if (end <= begin)
+			continue;
+
+		slabs.emplace_back();
+		slabs.back().begin = begin;
+		slabs.back().end = end;
+		slab_ends.push_back(end);
+	}
+
+	auto slab_of = [&](uint32_t event) {
+		return (size_t)(std::upper_bound(slab_ends.begin(), slab_ends.end(), event) - slab_ends.begin());
+	};
+
+	auto removes_previous_edge = [&](const Vertex2dDCELWrapper<DCEL>& vertex) {
+		return vertex.category == VERTEX_CATEGORY::END || vertex.category == VERTEX_CATEGORY::MERGE
+			|| (vertex.category == VERTEX_CATEGORY::REGULAR && is_regular_left(dcel, vertex.vert));
+	};
+
+	// An edge goes in to the sweep line at its origin (start, split and regular left vertices) and
+	// comes out at its destination, it is a seed of every slab in between
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const auto& vertex = vertices[i];
+		if (vertex.category != VERTEX_CATEGORY::START && vertex.category != VERTEX_CATEGORY::SPLIT
+			&& !(vertex.category == VERTEX_CATEGORY::REGULAR && is_regular_left(dcel, vertex.vert)))
+			continue;
+
+		auto edge = dcel.incidentEdge(vertex.vert);
+		uint32_t removed = rank[dcel.index(dcel.destination(edge))];
+		size_t last = removes_previous_edge(vertices[removed]) ? slab_of(removed) : slabs.size() - 1;
+		for (size_t s = slab_of(i) + 1; s <= last; s++)
+			slabs[s].seed_edges.push_back(edge);
+	}
+
+	// Edges are only looked up (EdgeMapper::operator[]) in the slab they leave the sweep line in, so
+	// each entry is written by one slab
+	std::vector<uint32_t> seed_slot(count);
+
+	parallel_for(slabs.size(), [&](size_t s) {
+		SweepSlab<DCEL>& slab = slabs[s];
+		Vector<type, DIM2> sweep_point = dcel.point(vertices[slab.begin].vert);
+
+		std::vector<Wrapper> seeds;
+		seeds.reserve(slab.seed_edges.size());
+		for (auto edge : slab.seed_edges)
+		{
+			Vertex2dDCELWrapper<DCEL> pending{ dcel.origin(edge), VERTEX_CATEGORY::INVALID };
+			seeds.push_back(Wrapper(dcel, edge, pending));
 		}
+
+		// Left to right at the top of the slab. Two seeds can only meet there at a vertex, then they
+		// are ordered where the later one of them went in to the sweep line, as in the serial sweep.
+		std::sort(seeds.begin(), seeds.end(), [&](const Wrapper& a, const Wrapper& b) {
+			int order = a.compareX(b, sweep_point);
+			if (order != 0)
+				return order < 0;
+			bool a_later = rank[dcel.index(a.helper.vert)] > rank[dcel.index(b.helper.vert)];
+			const auto& inserted_at = dcel.point(a_later ? a.helper.vert : b.helper.vert);
+			return a.compareX(b, inserted_at) < 0;
+		});
+
+		SweepLineComparator<DCEL> comp(&sweep_point);
+		SweepLine<DCEL> sweep_line(comp);
+		for (uint32_t j = 0; j < seeds.size(); j++)
+		{
+			uint32_t removed = rank[dcel.index(dcel.destination(seeds[j].edge))];
+			if (removed >= slab.begin && removed < slab.end)
+				seed_slot[dcel.index(seeds[j].helper.vert)] = j;
+			sweep_line.append(&seeds[j]);
+		}
+
+		EdgeMapper<DCEL> edge_mapping(dcel, wrappers.data());
+		edge_mapping.rank = rank.data();
+		edge_mapping.first_event = slab.begin;
+		edge_mapping.seeds = seeds.data();
+		edge_mapping.seed_slot = seed_slot.data();
+
+		sweep_events(dcel, vertices, slab.begin, slab.end, sweep_point, sweep_line, edge_mapping, slab.diagonals);
+
+		// The helpers this slab knows are handed on to the ones below
+		for (auto it = sweep_line.begin(); it != sweep_line.end(); ++it)
+			if ((*it)->helper.category != VERTEX_CATEGORY::INVALID)
+				slab.helpers.push_back({ dcel.index(dcel.origin((*it)->edge)), (*it)->helper });
+	}, thread_count);
+
+	// Top to bottom, a pending diagonal goes to the helper its edge had at the top of the slab
+	std::vector<Vertex2dDCELWrapper<DCEL>> helper_of(count);
+	for (auto& slab : slabs)
+	{
+		const auto& pending = slab.diagonals.pending;
+		size_t next_pending = 0;
+		for (uint32_t k = 0; k < slab.diagonals.list.size(); k++)
+		{
+			auto diagonal = slab.diagonals.list[k];
+			if (next_pending < pending.size() && pending[next_pending].first == k)
+			{
+				const auto& helper = helper_of[dcel.index(diagonal.second)];
+				if (pending[next_pending++].second && helper.category != VERTEX_CATEGORY::MERGE)
+					continue;
+				diagonal.second = helper.vert;
+			}
+			diagonals.list.push_back(diagonal);
+		}
+
+		for (const auto& helper : slab.helpers)
+			helper_of[helper.first] = helper.second;
 	}
-	
-	for(auto vertices : polygon_pieces_vertices)
-		mono_polies.push_back(new Polygon2d(vertices));
-}
\ No newline at end of file
+}
+
+template<class DCEL>
+static void partition_monotone_sweep(DCEL* poly, unsigned thread_count, size_t slab_threshold)
+{
+	typedef typename DCEL::coordinate_type type;
+
+	if (thread_count == 0)
+		thread_count = default_thread_count();
+
+	std::vector<typename DCEL::VertexHandle> handles;
+	handles.reserve(poly->vertexCount());
+	for (auto vertex : poly->vertexRange())
+		handles.push_back(vertex);
+
+	if (handles.empty())
+		return;
+
+	// Visit the vertices top to bottom, left to right on equal y
+	std::vector<uint32_t> order;
+	build_event_queue<type>(handles.size(), [&](size_t i) -> const Vector<type, DIM2>& { return poly->point(handles[i]); }, order, thread_count);
+
+	// A category only depends on the vertex and its neighbours, so they are worked out in chunks
+	std::vector<Vertex2dDCELWrapper<DCEL>> vertices(order.size());
+	const size_t chunk = 1 << 14;
+	parallel_for((order.size() + chunk - 1) / chunk, [&](size_t c) {
+		const size_t end = std::min(order.size(), (c + 1) * chunk);
+		for (size_t i = c * chunk; i < end; i++)
+			vertices[i] = Vertex2dDCELWrapper<DCEL>{ handles[order[i]], categorize_vertex(*poly, handles[order[i]]) };
+	}, thread_count);
+
+	std::vector<Edge2dDCELWrapper<DCEL>> wrappers(vertices.size());
+	Diagonals<DCEL> diagonals;
+
+	if (thread_count > 1 && vertices.size() >= slab_threshold)
+		partition_monotone_slabs(*poly, vertices, wrappers, thread_count, diagonals);
+	else
+	{
+		Vector<type, DIM2> sweep_point = poly->point(vertices[0].vert);
+
+		SweepLineComparator<DCEL> comp(&sweep_point);
+		SweepLine<DCEL> sweep_line(comp);
+		EdgeMapper<DCEL> edge_mapping(*poly, wrappers.data());
+		sweep_events(*poly, vertices, 0, vertices.size(), sweep_point, sweep_line, edge_mapping, diagonals);
+	}
+
+	poly->splitMany(diagonals.list);
+}
+
+template<class type>
+void jmk::partition_monotone(PolygonDCEL<type, 2>* poly, unsigned thread_count, size_t slab_threshold)
+{
+	partition_monotone_sweep(poly, thread_count, slab_threshold);
+}
+
+template<class type>
+void jmk::partition_monotone(ArenaPolygonDCEL<type, 2>* poly, unsigned thread_count, size_t slab_threshold)
+{
+	partition_monotone_sweep(poly, thread_count, slab_threshold);
+}
+
+// Partition, then collect the bounded faces of poly
+template<class DCEL>
+static void partition_monotone_pieces(DCEL* poly, std::vector<typename DCEL::FaceHandle>& pieces, unsigned thread_count, size_t slab_threshold)
+{
+	partition_monotone_sweep(poly, thread_count, slab_threshold);
+
+	pieces.clear();
+	for (auto face : poly->faceRange())
+		if (poly->isBounded(face))
+			pieces.push_back(face);
+}
+
+template<class type>
+void jmk::partition_monotone(PolygonDCEL<type, 2>* poly, std::vector<FaceDCEL<type, 2>*>& pieces, unsigned thread_count, size_t slab_threshold)
+{
+	partition_monotone_pieces(poly, pieces, thread_count, slab_threshold);
+}
+
+template<class type>
+void jmk::partition_monotone(ArenaPolygonDCEL<type, 2>* poly, std::vector<uint32_t>& pieces, unsigned thread_count, size_t slab_threshold)
+{
+	partition_monotone_pieces(poly, pieces, thread_count, slab_threshold);
+}
+
+template<class type>
+void jmk::get_monotone_polygons(PolygonDCEL<type, 2>* poly, std::vector<PolygonDCEL<type, 2>*>& mono_polies, unsigned thread_count)
+{
+	std::vector<FaceDCEL<type, 2>*> pieces;
+	partition_monotone(poly, pieces, thread_count);
+
+	std::vector<Vector<type, DIM2>> vertices;
+	for (auto face_ptr : pieces) {
+		vertices.clear();
+		for (auto edge_ptr : face_ptr->boundary())
+			vertices.push_back(edge_ptr->origin->point);
+
+		mono_polies.push_back(new PolygonDCEL<type, 2>(vertices));
+	}
+}
+
+template<class type>
+void jmk::get_monotone_polygons(const PointView<type, DIM2>& points, std::vector<PolygonDCEL<type, 2>*>& mono_polies, unsigned thread_count)
+{
+	// The pieces are new polygons, so the working DCEL is released once they are built
+	PolygonDCEL<type, 2> poly(points);
+	get_monotone_polygons(&poly, mono_polies, thread_count);
+	poly.clear();
+}
+
+template void jmk::partition_monotone<float>(Polygon2d*, unsigned, size_t);
+template void jmk::partition_monotone<int32_t>(Polygon2i*, unsigned, size_t);
+template void jmk::partition_monotone<double>(Polygon2lf*, unsigned, size_t);
+template void jmk::partition_monotone<float>(ArenaPolygon2d*, unsigned, size_t);
+template void jmk::partition_monotone<int32_t>(ArenaPolygon2i*, unsigned, size_t);
+template void jmk::partition_monotone<double>(ArenaPolygon2lf*, unsigned, size_t);
+template void jmk::partition_monotone<float>(Polygon2d*, std::vector<Face2dDCEL*>&, unsigned, size_t);
+template void jmk::partition_monotone<int32_t>(Polygon2i*, std::vector<Face2iDCEL*>&, unsigned, size_t);
+template void jmk::partition_monotone<double>(Polygon2lf*, std::vector<Face2lfDCEL*>&, unsigned, size_t);
+template void jmk::partition_monotone<float>(ArenaPolygon2d*, std::vector<uint32_t>&, unsigned, size_t);
+template void jmk::partition_monotone<int32_t>(ArenaPolygon2i*, std::vector<uint32_t>&, unsigned, size_t);
+template void jmk::partition_monotone<double>(ArenaPolygon2lf*, std::vector<uint32_t>&, unsigned, size_t);
+template void jmk::get_monotone_polygons<float>(Polygon2d*, std::vector<Polygon2d*>&, unsigned);
+template void jmk::get_monotone_polygons<int32_t>(Polygon2i*, std::vector<Polygon2i*>&, unsigned);
+template void jmk::get_monotone_polygons<double>(Polygon2lf*, std::vector<Polygon2lf*>&, unsigned);
+template void jmk::get_monotone_polygons<float>(const PointView2f&, std::vector<Polygon2d*>&, unsigned);
+template void jmk::get_monotone_polygons<int32_t>(const PointView2i&, std::vector<Polygon2i*>&, unsigned);
+template void jmk::get_monotone_polygons<double>(const PointView2lf&, std::vector<Polygon2lf*>&, unsigned);
\ No newline at end of file
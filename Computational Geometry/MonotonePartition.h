@@ -1,11 +1,53 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include "Core\Base\Vector.h"
 #include "Core\Primitives\PolygonDCEL.h"
+#include "Core\Primitives\ArenaPolygonDCEL.h"
 #include "Core\GeoUtils.h"
 
 namespace jmk
 {
-	void get_monotone_polygons(Polygon2d* poly, std::vector<Polygon2d*>& mono_polies);
+	// The sweep can also run in horizontal slabs, one per thread, for polygons with at least
+	// slab_threshold vertices when more than one thread is allowed. The diagonals are the same as from
+	// the serial sweep. The slabs do more work in total: each one first sorts the edges crossing its top,
+	// and the helpers from above are stitched serially at the end. No speed up has been shown yet (see
+	// benchmark_slab_partition in main.cpp), on a single core a 1M vertex outline took 400 ms serially
+	// and 550 to 620 ms in 2 to 32 slabs. So slabs are off unless a caller passes a threshold, or the
+	// build defines this one. Threads are still used for the event queue and the categories.
+#ifndef MONOTONE_PARALLEL_THRESHOLD
+#define MONOTONE_PARALLEL_THRESHOLD SIZE_MAX
+#endif
+
+	// Partition the polygon in place. The diagonals are inserted in to poly, after which each of its
+	// bounded faces is a y-monotone piece. Uses up to thread_count threads (0 uses every hardware
+	// thread), the result does not depend on it.
+	template<class type>
+	void partition_monotone(PolygonDCEL<type, 2>* poly, unsigned thread_count = 0, size_t slab_threshold = MONOTONE_PARALLEL_THRESHOLD);
+
+	// Same on the index based DCEL
+	template<class type>
+	void partition_monotone(ArenaPolygonDCEL<type, 2>* poly, unsigned thread_count = 0, size_t slab_threshold = MONOTONE_PARALLEL_THRESHOLD);
+
+	// Same, and the pieces are returned as the bounded faces of poly. These are handles in to poly,
+	// nothing is copied, so they stay valid until poly is changed again.
+	template<class type>
+	void partition_monotone(PolygonDCEL<type, 2>* poly, std::vector<FaceDCEL<type, 2>*>& pieces, unsigned thread_count = 0,
+		size_t slab_threshold = MONOTONE_PARALLEL_THRESHOLD);
+
+	template<class type>
+	void partition_monotone(ArenaPolygonDCEL<type, 2>* poly, std::vector<uint32_t>& pieces, unsigned thread_count = 0,
+		size_t slab_threshold = MONOTONE_PARALLEL_THRESHOLD);
+
+	// Partition the polygon in to y-monotone pieces, each copied in to a new polygon owned by the
+	// caller. Use the partition_monotone overloads above to work on the pieces in place.
+	// Instantiated for float (Polygon2d), double (Polygon2lf) and int32_t (Polygon2i). The int32_t
+	// partition is exact, including vertices of equal y, which are taken left to right.
+	template<class type>
+	void get_monotone_polygons(PolygonDCEL<type, 2>* poly, std::vector<PolygonDCEL<type, 2>*>& mono_polies, unsigned thread_count = 0);
+
+	// Same for a polygon given as a view over its points (counter-clockwise order)
+	template<class type>
+	void get_monotone_polygons(const PointView<type, DIM2>& points, std::vector<PolygonDCEL<type, 2>*>& mono_polies, unsigned thread_count = 0);
 }
\ No newline at end of file
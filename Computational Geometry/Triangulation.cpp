@@ -1,146 +1,467 @@
 #include "Triangulation.h"
 #include <algorithm>
-#include <stack>
+#include <deque>
 #include <map>
 #include "Core\GeoUtils.h"
+#include "Core\Predicates.h"
+#include "Core\Base\Parallel.h"
 
 using namespace jmk;
 
-static bool is_in_same_chain(Vertex2dDCEL* a, Vertex2dDCEL* b)
+// Working buffers of triangulate_monotone_ring. One is reused for every piece of a partition, so once
+// the buffers have grown to the largest piece, triangulating a piece does not allocate.
+template<class DCEL>
+struct MonotoneRingScratch
 {
-	if (a->incident_edge->prev->origin == b || a->incident_edge->next->origin == b)
-		return true;
-	return false;
+	std::vector<typename DCEL::VertexHandle> ring;   // Ring of the face being triangulated, see load_face_ring
+	std::vector<uint8_t> on_left;
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> stack;
+};
+
+// Put the counter-clockwise ring of the face's outer boundary in scratch.ring
+template<class DCEL>
+static void load_face_ring(const DCEL& dcel, typename DCEL::FaceHandle face, MonotoneRingScratch<DCEL>& scratch)
+{
+	scratch.ring.clear();
+	for (auto edge : dcel.faceBoundary(face))
+		scratch.ring.push_back(dcel.origin(edge));
 }
 
-// Vertex should be in a monotone polygon
-// a[Y] <= b[Y]
-static bool valid_diagonal_DCEL(Vertex2dDCEL* a, Vertex2dDCEL* b)
+// Stack triangulation of a monotone piece given as its counter-clockwise ring of vertices, in O(n).
+// triangle(a, b, c) is called for every triangle (counter-clockwise) and diagonal(a, b) for every
+// diagonal, n - 2 and n - 3 times. The vertices are handles of either DCEL backend.
+template<class DCEL, class Triangle, class Diagonal>
+static void triangulate_monotone_ring(const DCEL& dcel, const std::vector<typename DCEL::VertexHandle>& ring,
+	MonotoneRingScratch<DCEL>& scratch, Triangle triangle, Diagonal diagonal)
 {
-	// TODO this is wrong. have to modify. Here only incode test would be needed.
-	auto edge = a->incident_edge;
-	// If the vertices are adjucent we can return.
-	if (edge->next->origin == b || edge->prev->origin == b)
-		return false;
+	typedef typename DCEL::coordinate_type coord_type;
 
-	if (a->point[X] <= b->point[X]) {
-		edge = edge->prev;
-		while (edge->origin != b) {
-			if (!left(a->point, b->point, edge->origin->point))
-				return false;
-			edge = edge->prev;
+	const uint32_t size = (uint32_t)ring.size();
+	if (size < 3)
+		return;
+
+	Vertex2DSortTBLR above;
+	uint32_t top = 0, bottom = 0;
+	for (uint32_t i = 1; i < size; i++)
+	{
+		if (above(dcel.point(ring[i]), dcel.point(ring[top])))
+			top = i;
+		if (above(dcel.point(ring[bottom]), dcel.point(ring[i])))
+			bottom = i;
+	}
+
+	// Label the chains. From the top vertex the counter-clockwise ring runs down the left chain to
+	// the bottom vertex, then back up the right chain.
+	std::vector<uint8_t>& on_left = scratch.on_left;
+	on_left.assign(size, 0);
+	for (uint32_t i = top; i != bottom; i = (i + 1) % size)
+		on_left[i] = true;
+
+	// Both chains are already sorted from top to bottom, the left one forwards from top and the right
+	// one backwards, so merging them gives the order of the whole ring
+	std::vector<uint32_t>& order = scratch.order;
+	order.clear();
+	uint32_t l = top, r = (top + size - 1) % size;
+	while (l != bottom || r != bottom)
+	{
+		if (r == bottom || (l != bottom && above(dcel.point(ring[l]), dcel.point(ring[r]))))
+		{
+			order.push_back(l);
+			l = (l + 1) % size;
+		}
+		else
+		{
+			order.push_back(r);
+			r = (r + size - 1) % size;
 		}
 	}
-	else {
-		edge = edge->next;
-		while (edge->origin != b) {
-			if (left(a->point, b->point, edge->origin->point))
-				return false;
-			edge = edge->next;
+	order.push_back(bottom);
+
+	auto point = [&](uint32_t i) -> const Vector<coord_type, DIM2>& { return dcel.point(ring[i]); };
+
+	// Triangle between u and the stack edge upper -> lower, in counter-clockwise order. The stack is
+	// on the chain opposite to u (except maybe its first vertex, which does not change the order).
+	auto fan = [&](uint32_t u, bool u_on_left, uint32_t upper, uint32_t lower) {
+		if (u_on_left)
+			triangle(ring[u], ring[lower], ring[upper]);
+		else
+			triangle(ring[u], ring[upper], ring[lower]);
+	};
+
+	std::vector<uint32_t>& stack = scratch.stack;
+	stack.clear();
+	stack.push_back(order[0]);
+	stack.push_back(order[1]);
+
+	for (uint32_t i = 2; i < size - 1; i++)
+	{
+		uint32_t u = order[i];
+		if (on_left[u] != on_left[stack.back()])
+		{
+			// u sees the whole stack. The first stack vertex is its neighbour on the boundary, every
+			// other one gets a diagonal. Only the last edge stays.
+			for (size_t k = 0; k + 1 < stack.size(); k++)
+			{
+				fan(u, on_left[u], stack[k], stack[k + 1]);
+				diagonal(ring[u], ring[stack[k + 1]]);
+			}
+
+			uint32_t last = stack.back();
+			stack.clear();
+			stack.push_back(last);
+			stack.push_back(u);
+		}
+		else
+		{
+			// Same chain. u -> upper is a diagonal as long as the corner at the popped vertex is convex,
+			// seen from the interior, which is one orientation test against the stack top.
+			uint32_t last = stack.back();
+			stack.pop_back();
+			while (!stack.empty())
+			{
+				uint32_t upper = stack.back();
+				bool convex = on_left[u]
+					? orient2d(point(upper), point(last), point(u)) > 0
+					: orient2d(point(u), point(last), point(upper)) > 0;
+				if (!convex)
+					break;
+
+				if (on_left[u])
+					triangle(ring[upper], ring[last], ring[u]);
+				else
+					triangle(ring[u], ring[last], ring[upper]);
+				diagonal(ring[u], ring[upper]);
+
+				last = upper;
+				stack.pop_back();
+			}
+			stack.push_back(last);
+			stack.push_back(u);
 		}
 	}
 
-	return true;
+	// The bottom vertex sees every vertex left on the stack. The last one is its neighbour.
+	uint32_t u = order[size - 1];
+	bool stack_on_left = on_left[stack.back()];
+	for (size_t k = 0; k + 1 < stack.size(); k++)
+	{
+		fan(u, !stack_on_left, stack[k], stack[k + 1]);
+		if (k + 2 < stack.size())
+			diagonal(ring[u], ring[stack[k + 1]]);
+	}
+}
+
+// Writes the triangles of the ring as 3 * (ring.size() - 2) indices (the vertex index) to out
+template<class DCEL>
+static void triangulate_monotone_ring(const DCEL& dcel, const std::vector<typename DCEL::VertexHandle>& ring,
+	MonotoneRingScratch<DCEL>& scratch, uint32_t* out)
+{
+	typedef typename DCEL::VertexHandle Vertex;
+
+	triangulate_monotone_ring(dcel, ring, scratch,
+		[&](Vertex a, Vertex b, Vertex c) {
+			*out++ = dcel.index(a);
+			*out++ = dcel.index(b);
+			*out++ = dcel.index(c);
+		},
+		[](Vertex, Vertex) {});
 }
 
-static void triangulate(Polygon2d* poly, std::vector<Vertex2dDCEL*>& vertices)
+template<class DCEL>
+static void triangulate_monotone_split(DCEL* poly)
 {
-	if (vertices.size() == 3)
+	typedef typename DCEL::VertexHandle Vertex;
+
+	// The diagonals are found on the untouched ring first, then inserted in one go
+	std::vector<std::pair<Vertex, Vertex>> diagonals;
+	MonotoneRingScratch<DCEL> scratch;
+	triangulate_monotone_ring(*poly, poly->getVertexList(), scratch,
+		[](Vertex, Vertex, Vertex) {},
+		[&diagonals](Vertex a, Vertex b) { diagonals.push_back({ a, b }); });
+
+	poly->splitMany(diagonals);
+}
+
+template<class DCEL>
+static void triangulate_monotone_indexed(DCEL* poly, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	std::vector<typename DCEL::VertexHandle> vertices = poly->getVertexList();
+
+	triangles.clear();
+	if (vertices.size() < 3)
 		return;
 
-	std::sort(vertices.begin(), vertices.end(), Vertex2DSortTBLR());
-	std::stack<Vertex2dDCEL*> vertex_stack;
-	vertex_stack.push(vertices[0]);
-	vertex_stack.push(vertices[1]);
-
-	for (size_t i = 2; i < vertices.size() - 1; i++) {
-		if (!is_in_same_chain(vertices[i], vertex_stack.top())) {
-			bool popped = false;
-			Vertex2dDCEL* top = vertex_stack.top();
-
-			while (!vertex_stack.empty()) {
-				if (vertex_stack.size() > 1)
-					poly->split(vertices[i], vertex_stack.top());
-				vertex_stack.pop();
-				//popped = true;
-			}
+	triangles.resize(3 * (vertices.size() - 2));
+	MonotoneRingScratch<DCEL> scratch;
+	triangulate_monotone_ring(*poly, vertices, scratch, triangles.data());
+
+	if (adjacency)
+		triangle_adjacency(triangles, *adjacency);
+}
 
-			//if(popped)
-			if (top)
-				vertex_stack.push(top);
-			vertex_stack.push(vertices[i]);
+// The faces are triangulated one after the other on one set of buffers, and all the diagonals are
+// inserted in one go at the end
+template<class DCEL>
+static void triangulate_monotone_faces_split(DCEL* poly, const std::vector<typename DCEL::FaceHandle>& faces)
+{
+	typedef typename DCEL::VertexHandle Vertex;
+
+	std::vector<std::pair<Vertex, Vertex>> diagonals;
+	MonotoneRingScratch<DCEL> scratch;
+	for (auto face : faces)
+	{
+		load_face_ring(*poly, face, scratch);
+		triangulate_monotone_ring(*poly, scratch.ring, scratch,
+			[](Vertex, Vertex, Vertex) {},
+			[&diagonals](Vertex a, Vertex b) { diagonals.push_back({ a, b }); });
+	}
+
+	poly->splitMany(diagonals);
+}
+
+template<class DCEL>
+static void triangulate_monotone_faces_indexed(DCEL* poly, const std::vector<typename DCEL::FaceHandle>& faces,
+	std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	// Sized up front from the boundary lengths, so every face writes straight in to its range
+	size_t total = 0;
+	for (auto face : faces)
+	{
+		size_t count = 0;
+		for (auto edge : poly->faceBoundary(face))
+		{
+			(void)edge;
+			count++;
 		}
-		else {
-			Vertex2dDCEL* top_before_ops = vertex_stack.top();
-			vertex_stack.pop();
-			Vertex2dDCEL* last_vertex_ptr = nullptr;
-			Vertex2dDCEL* last_diagonal_vert = nullptr;
-
-			//bool diagonal_added = false;
-
-			while (vertex_stack.size() != 0) {
-				last_vertex_ptr = vertex_stack.top();
-				if (valid_diagonal_DCEL(vertices[i], last_vertex_ptr)) {
-					poly->split(vertices[i], last_vertex_ptr);
-					last_diagonal_vert = last_vertex_ptr;
-				}
-				else {
-					break;
-				}
-				vertex_stack.pop();
-			}
+		if (count >= 3)
+			total += 3 * (count - 2);
+	}
+	triangles.resize(total);
 
-			if (last_diagonal_vert) {
-				vertex_stack.push(last_diagonal_vert);
-			}
-			else {
-				vertex_stack.push(top_before_ops);
-			}
-			vertex_stack.push(vertices[i]);
+	MonotoneRingScratch<DCEL> scratch;
+	uint32_t* out = triangles.data();
+	for (auto face : faces)
+	{
+		load_face_ring(*poly, face, scratch);
+		if (scratch.ring.size() < 3)
+			continue;
+		triangulate_monotone_ring(*poly, scratch.ring, scratch, out);
+		out += 3 * (scratch.ring.size() - 2);
+	}
+
+	if (adjacency)
+		triangle_adjacency(triangles, *adjacency);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone(PolygonDCEL<coord_type, 2>* poly)
+{
+	triangulate_monotone_split(poly);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone(ArenaPolygonDCEL<coord_type, 2>* poly)
+{
+	triangulate_monotone_split(poly);
+}
+
+template void jmk::triangulate_monotone<float>(Polygon2d*);
+template void jmk::triangulate_monotone<int32_t>(Polygon2i*);
+template void jmk::triangulate_monotone<double>(Polygon2lf*);
+template void jmk::triangulate_monotone<float>(ArenaPolygon2d*);
+template void jmk::triangulate_monotone<int32_t>(ArenaPolygon2i*);
+template void jmk::triangulate_monotone<double>(ArenaPolygon2lf*);
+
+template<class coord_type>
+void jmk::triangulate_monotone(PolygonDCEL<coord_type, 2>* poly, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	triangulate_monotone_indexed(poly, triangles, adjacency);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone(ArenaPolygonDCEL<coord_type, 2>* poly, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	triangulate_monotone_indexed(poly, triangles, adjacency);
+}
+
+template void jmk::triangulate_monotone<float>(Polygon2d*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone<int32_t>(Polygon2i*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone<double>(Polygon2lf*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone<float>(ArenaPolygon2d*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone<int32_t>(ArenaPolygon2i*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone<double>(ArenaPolygon2lf*, std::vector<uint32_t>&, std::vector<uint32_t>*);
+
+template<class coord_type>
+void jmk::triangulate_monotone_faces(PolygonDCEL<coord_type, 2>* poly, const std::vector<FaceDCEL<coord_type, 2>*>& faces)
+{
+	triangulate_monotone_faces_split(poly, faces);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone_faces(ArenaPolygonDCEL<coord_type, 2>* poly, const std::vector<uint32_t>& faces)
+{
+	triangulate_monotone_faces_split(poly, faces);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone_faces(PolygonDCEL<coord_type, 2>* poly, const std::vector<FaceDCEL<coord_type, 2>*>& faces,
+	std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	triangulate_monotone_faces_indexed(poly, faces, triangles, adjacency);
+}
+
+template<class coord_type>
+void jmk::triangulate_monotone_faces(ArenaPolygonDCEL<coord_type, 2>* poly, const std::vector<uint32_t>& faces,
+	std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	triangulate_monotone_faces_indexed(poly, faces, triangles, adjacency);
+}
+
+template void jmk::triangulate_monotone_faces<float>(Polygon2d*, const std::vector<Face2dDCEL*>&);
+template void jmk::triangulate_monotone_faces<int32_t>(Polygon2i*, const std::vector<Face2iDCEL*>&);
+template void jmk::triangulate_monotone_faces<double>(Polygon2lf*, const std::vector<Face2lfDCEL*>&);
+template void jmk::triangulate_monotone_faces<float>(ArenaPolygon2d*, const std::vector<uint32_t>&);
+template void jmk::triangulate_monotone_faces<int32_t>(ArenaPolygon2i*, const std::vector<uint32_t>&);
+template void jmk::triangulate_monotone_faces<double>(ArenaPolygon2lf*, const std::vector<uint32_t>&);
+template void jmk::triangulate_monotone_faces<float>(Polygon2d*, const std::vector<Face2dDCEL*>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone_faces<int32_t>(Polygon2i*, const std::vector<Face2iDCEL*>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone_faces<double>(Polygon2lf*, const std::vector<Face2lfDCEL*>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone_faces<float>(ArenaPolygon2d*, const std::vector<uint32_t>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone_faces<int32_t>(ArenaPolygon2i*, const std::vector<uint32_t>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template void jmk::triangulate_monotone_faces<double>(ArenaPolygon2lf*, const std::vector<uint32_t>&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+
+template<class coord_type>
+void jmk::triangulate_general(const PointView<coord_type, DIM2>& points, std::vector<uint32_t>& triangles, unsigned thread_count)
+{
+	triangles.clear();
+	if (points.size() < 3)
+		return;
+
+	// The working DCEL only lives for this call, so the index based one is used. It is built and
+	// released with a few allocations instead of one per element.
+	ArenaPolygonDCEL<coord_type, 2> poly(points);
+	std::vector<uint32_t> pieces;
+	partition_monotone(&poly, pieces, thread_count);
+
+	// A piece with m vertices gives m - 2 triangles, so the range of each piece is known up front
+	std::vector<size_t> offsets(pieces.size() + 1, 0);
+	for (size_t i = 0; i < pieces.size(); i++)
+	{
+		size_t count = 0;
+		for (auto edge : poly.faceBoundary(pieces[i]))
+		{
+			(void)edge;
+			count++;
 		}
+		offsets[i + 1] = offsets[i] + 3 * (count - 2);
 	}
+	triangles.resize(offsets.back());
+
+	// The pieces are read straight from the DCEL. They are handed out in a few runs per thread, each
+	// run with its own buffers, so nothing is allocated per piece.
+	if (thread_count == 0)
+		thread_count = default_thread_count();
+	const size_t runs = std::min(pieces.size(), 4 * (size_t)thread_count);
+	parallel_for(runs, [&](size_t r) {
+		MonotoneRingScratch<ArenaPolygonDCEL<coord_type, 2>> scratch;
+		const size_t end = (r + 1) * pieces.size() / runs;
+		for (size_t i = r * pieces.size() / runs; i < end; i++)
+		{
+			load_face_ring(poly, pieces[i], scratch);
+			triangulate_monotone_ring(poly, scratch.ring, scratch, triangles.data() + offsets[i]);
+		}
+	}, thread_count);
 
-	if (vertex_stack.size() != 0)
-		vertex_stack.pop();
+	poly.clear();
+}
 
-	auto size = vertices.size();
-	while (vertex_stack.size() > 1)
+template void jmk::triangulate_general<float>(const PointView2f&, std::vector<uint32_t>&, unsigned);
+template void jmk::triangulate_general<int32_t>(const PointView2i&, std::vector<uint32_t>&, unsigned);
+template void jmk::triangulate_general<double>(const PointView2lf&, std::vector<uint32_t>&, unsigned);
+
+void jmk::triangle_adjacency(const std::vector<uint32_t>& triangles, std::vector<uint32_t>& adjacency)
+{
+	adjacency.assign(triangles.size(), NO_ADJACENT_TRIANGLE);
+
+	// Key every edge by its sorted end points, so the two sides of an inner edge end up next to
+	// each other after sorting
+	std::vector<std::pair<uint64_t, uint32_t>> edges;
+	edges.reserve(triangles.size());
+	for (uint32_t slot = 0; slot < triangles.size(); slot++)
 	{
-		poly->split(vertices[size - 1], vertex_stack.top());
-		vertex_stack.pop();
+		uint32_t a = triangles[slot];
+		uint32_t b = triangles[slot % 3 == 2 ? slot - 2 : slot + 1];
+		edges.push_back({ ((uint64_t)std::min(a, b) << 32) | std::max(a, b), slot });
 	}
+	std::sort(edges.begin(), edges.end());
 
-	vertex_stack.pop();
+	for (size_t i = 0; i + 1 < edges.size(); i++)
+	{
+		if (edges[i].first == edges[i + 1].first)
+		{
+			adjacency[edges[i].second] = edges[i + 1].second / 3;
+			adjacency[edges[i + 1].second] = edges[i].second / 3;
+			i++;
+		}
+	}
 }
 
-void jmk::triangulate_monotone(Polygon2d* poly)
+// Size the grid to the bounding box of the ring starting at start and insert every edge v -> next(v)
+template<class Grid, class Handle, class PointOf, class Next>
+static void build_edge_grid(Grid& grid, Handle start, size_t count, PointOf point, Next next)
 {
-	std::vector<Vertex2dDCEL*> vertices = poly->getVertexList();
-	triangulate(poly, vertices);
+	auto lo = point(start), hi = point(start);
+	Handle current = start;
+	do {
+		const auto& p = point(current);
+		for (int i = X; i <= Y; i++)
+		{
+			lo[i] = std::min(lo[i], p[i]);
+			hi[i] = std::max(hi[i], p[i]);
+		}
+		current = next(current);
+	} while (current != start);
+
+	grid.reset(lo, hi, count);
+	do {
+		grid.insert(current, next(current), point(current), point(next(current)));
+		current = next(current);
+	} while (current != start);
 }
 
-static void initialize_ear_status(Polygon2dSimple* polygon)
+template<class coord_type>
+static void initialize_ear_status(PolygonSimple<coord_type>* polygon, const EdgeGrid<coord_type, const VertexSimple<coord_type>*>& grid)
 {
-	Vertex2dSimple* v0, * v1, * v2;
+	VertexSimple<coord_type>* v0, * v1, * v2;
 
 	auto vertices = polygon->getVertices();
 	v1 = vertices[0];
 	do {
 		v0 = v1->prev;
 		v2 = v1->next;
-		v1->is_ear = isDiagonal(v0, v2);
+		v1->is_ear = isDiagonal(v0, v2, grid);
 		v1 = v1->next;
 	} while (v1 != vertices[0]);
 }
 
-void jmk::triangulate_earclipping(Polygon2dSimple* poly, std::vector<Edge2dSimple>& edge_list) {
+template<class coord_type>
+void jmk::triangulate_earclipping(PolygonSimple<coord_type>* poly, std::vector<EdgeSimple<coord_type>>& edge_list) {
 
-	initialize_ear_status(poly);
+	typedef const VertexSimple<coord_type>* Handle;
 
 	auto vertex_list = poly->getVertices();
 	int no_vertex_to_process = vertex_list.size();
 
-	Vertex2dSimple* v0, * v1, * v2, * v3, * v4;
+	// Live edges of the remaining ring, updated as ears are clipped
+	EdgeGrid<coord_type, Handle> grid;
+	build_edge_grid(grid, (Handle)vertex_list[0], vertex_list.size(),
+		[](Handle v) -> const Vector<coord_type, DIM2>& { return v->point; },
+		[](Handle v) -> Handle { return v->next; });
+
+	initialize_ear_status(poly, grid);
+
+	VertexSimple<coord_type>* v0, * v1, * v2, * v3, * v4;
 	int index = 0;
 
 	while (no_vertex_to_process > 3) {
@@ -154,16 +475,20 @@ void jmk::triangulate_earclipping(Polygon2dSimple* poly, std::vector<Edge2dSimpl
 				v1 = v2->prev;
 				v0 = v1->prev;
 
-				edge_list.push_back(Edge2dSimple(v1->point, v3->point));
+				edge_list.push_back(EdgeSimple<coord_type>(v1->point, v3->point));
 				v2->is_processed = true;
 
 				// Aca se corta el polygon
 				v1->next = v3;
 				v3->prev = v1;
 
+				grid.remove(v1, v2, v1->point, v2->point);
+				grid.remove(v2, v3, v2->point, v3->point);
+				grid.insert(v1, v3, v1->point, v3->point);
+
 				// Chekeo si es oreja:
-				v1->is_ear = isDiagonal(v0, v3, nullptr);
-				v3->is_ear = isDiagonal(v1, v4, nullptr);
+				v1->is_ear = isDiagonal(v0, v3, grid);
+				v3->is_ear = isDiagonal(v1, v4, grid);
 
 				no_vertex_to_process--;
 				index++;
@@ -171,4 +496,184 @@ void jmk::triangulate_earclipping(Polygon2dSimple* poly, std::vector<Edge2dSimpl
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+template void jmk::triangulate_earclipping<float>(Polygon2dSimple*, std::vector<Edge2dSimple>&);
+template void jmk::triangulate_earclipping<int32_t>(Polygon2iSimple*, std::vector<Edge2iSimple>&);
+template void jmk::triangulate_earclipping<double>(Polygon2lfSimple*, std::vector<Edge2lfSimple>&);
+
+// Strictly convex corner prev -> v -> next of a counter-clockwise ring
+template<class coord_type>
+static bool is_convex(const PointView<coord_type, DIM2>& points, uint32_t prev, uint32_t v, uint32_t next)
+{
+	return orient2d(points[prev], points[v], points[next]) > 0;
+}
+
+// Clips the ears of the ring of points one by one. clip(v1, v2, v3, last) is called for every clipped
+// ear v1 v2 v3 (counter-clockwise, v2 is the removed vertex) and once more with last set for the
+// triangle left at the end. Returns false if the ring ran out of ears before that (it was not simple),
+// then fewer than n - 2 triangles were reported.
+template<class coord_type, class Clip>
+static bool clip_ears(const PointView<coord_type, DIM2>& points, Clip clip)
+{
+	const uint32_t size = (uint32_t)points.size();
+	if (size < 3)
+		return false;
+
+	std::vector<uint32_t> next(size), prev(size);
+	for (uint32_t i = 0; i < size; i++)
+	{
+		next[i] = (i + 1) % size;
+		prev[i] = (i + size - 1) % size;
+	}
+
+	// Only reflex (and collinear) vertices can lie inside a candidate ear, so only those are kept in
+	// the grid, as zero length segments. Clipping can only make a vertex more convex, so the set
+	// never grows.
+	auto lo = points[0], hi = points[0];
+	for (uint32_t i = 1; i < size; i++)
+	{
+		for (int k = X; k <= Y; k++)
+		{
+			lo[k] = std::min(lo[k], points[i][k]);
+			hi[k] = std::max(hi[k], points[i][k]);
+		}
+	}
+
+	std::vector<bool> is_reflex(size);
+	uint32_t reflex_count = 0;
+	for (uint32_t i = 0; i < size; i++)
+	{
+		is_reflex[i] = !is_convex(points, prev[i], i, next[i]);
+		reflex_count += is_reflex[i];
+	}
+
+	EdgeGrid<coord_type, uint32_t> reflex_grid;
+	reflex_grid.reset(lo, hi, std::max(reflex_count, 1u));
+	for (uint32_t i = 0; i < size; i++)
+		if (is_reflex[i])
+			reflex_grid.insert(i, i, points[i], points[i]);
+
+	// A vertex that failed the ear test because of a reflex vertex is parked on that vertex and queued
+	// again once it leaves the reflex set. Together with re queuing the neighbours of every clipped
+	// ear, no vertex ever has to be looked at again by scanning the ring.
+	std::vector<std::vector<uint32_t>> blocked(size);
+	std::deque<uint32_t> queue;
+	std::vector<bool> is_queued(size, true), is_processed(size, false);
+	for (uint32_t i = 0; i < size; i++)
+		queue.push_back(i);
+
+	auto enqueue = [&](uint32_t v) {
+		if (!is_queued[v] && !is_processed[v])
+		{
+			is_queued[v] = true;
+			queue.push_back(v);
+		}
+	};
+
+	auto leave_reflex_set = [&](uint32_t v) {
+		is_reflex[v] = false;
+		reflex_grid.remove(v, v, points[v], points[v]);
+		for (uint32_t w : blocked[v])
+			enqueue(w);
+		blocked[v].clear();
+	};
+
+	// Returns the reflex vertex inside or on the triangle v1 v2 v3, or v2 if there is none. Only the grid
+	// cells under the triangle are visited, not its bounding box: the ears of spiky polygons are long
+	// and thin, their boxes would cover a large part of the grid.
+	auto find_blocker = [&](uint32_t v1, uint32_t v2, uint32_t v3) {
+		const auto& a = points[v1], & b = points[v2], & c = points[v3];
+		uint32_t blocker = v2;
+		reflex_grid.anyPoint(a, b, c, [&](const typename EdgeGrid<coord_type, uint32_t>::Entry& entry) {
+			uint32_t r = entry.from;
+			if (r == v1 || r == v2 || r == v3)
+				return false;
+			if (orient2d(a, b, entry.a) >= 0 && orient2d(b, c, entry.a) >= 0 && orient2d(c, a, entry.a) >= 0)
+			{
+				blocker = r;
+				return true;
+			}
+			return false;
+		});
+		return blocker;
+	};
+
+	uint32_t no_vertex_to_process = size;
+
+	while (no_vertex_to_process > 3 && !queue.empty())
+	{
+		uint32_t v2 = queue.front();
+		queue.pop_front();
+		is_queued[v2] = false;
+
+		if (is_processed[v2] || is_reflex[v2])
+			continue;
+
+		uint32_t v1 = prev[v2], v3 = next[v2];
+		uint32_t blocker = find_blocker(v1, v2, v3);
+		if (blocker != v2)
+		{
+			blocked[blocker].push_back(v2);
+			continue;
+		}
+
+		clip(v1, v2, v3, false);
+		is_processed[v2] = true;
+
+		next[v1] = v3;
+		prev[v3] = v1;
+		no_vertex_to_process--;
+
+		// The corners at v1 and v3 changed, so their status may have changed too
+		if (is_reflex[v1] && is_convex(points, prev[v1], v1, v3))
+			leave_reflex_set(v1);
+		if (is_reflex[v3] && is_convex(points, v1, v3, next[v3]))
+			leave_reflex_set(v3);
+
+		enqueue(v1);
+		enqueue(v3);
+	}
+
+	if (no_vertex_to_process > 3)
+		return false;
+
+	uint32_t v = 0;
+	while (is_processed[v])
+		v++;
+	clip(prev[v], v, next[v], true);
+	return true;
+}
+
+template<class coord_type>
+bool jmk::triangulate_earclipping(const PointView<coord_type, DIM2>& points, std::vector<EdgeSimple<coord_type>>& edge_list)
+{
+	return clip_ears(points, [&](uint32_t v1, uint32_t, uint32_t v3, bool last) {
+		if (!last)
+			edge_list.push_back(EdgeSimple<coord_type>(points[v1], points[v3]));
+	});
+}
+
+template<class coord_type>
+bool jmk::triangulate_earclipping(const PointView<coord_type, DIM2>& points, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency)
+{
+	triangles.clear();
+	triangles.reserve(points.size() < 3 ? 0 : 3 * (points.size() - 2));
+
+	bool complete = clip_ears(points, [&](uint32_t v1, uint32_t v2, uint32_t v3, bool) {
+		triangles.push_back(v1);
+		triangles.push_back(v2);
+		triangles.push_back(v3);
+	});
+
+	if (adjacency)
+		triangle_adjacency(triangles, *adjacency);
+	return complete;
+}
+
+template bool jmk::triangulate_earclipping<float>(const PointView2f&, std::vector<Edge2dSimple>&);
+template bool jmk::triangulate_earclipping<int32_t>(const PointView2i&, std::vector<Edge2iSimple>&);
+template bool jmk::triangulate_earclipping<double>(const PointView2lf&, std::vector<Edge2lfSimple>&);
+template bool jmk::triangulate_earclipping<float>(const PointView2f&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template bool jmk::triangulate_earclipping<int32_t>(const PointView2i&, std::vector<uint32_t>&, std::vector<uint32_t>*);
+template bool jmk::triangulate_earclipping<double>(const PointView2lf&, std::vector<uint32_t>&, std::vector<uint32_t>*);
@@ -1,21 +1,89 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <iostream>
 
 #include "Core\Primitives\Point.h"
 #include "Core\Primitives\PolygonDCEL.h"
+#include "Core\Primitives\ArenaPolygonDCEL.h"
 #include "MonotonePartition.h"
 
 namespace jmk {
 
+	// Adjacency entry for a triangle edge on the polygon boundary
+#define NO_ADJACENT_TRIANGLE UINT32_MAX
+
+	// The triangulation functions are instantiated for float (Polygon2dSimple / Polygon2d), double
+	// (Polygon2lfSimple / Polygon2lf) and int32_t (Polygon2iSimple / Polygon2i) coordinates.
+	// Integer polygons are triangulated exactly over the whole int32 range: the predicates are exact,
+	// vertices of equal y are ordered left to right in every step, and the monotone sweep only trusts
+	// its double interpolated edge positions when they are far enough apart to be certain.
+
 	// triangulate the given polygon using ear clipping method
-	void triangulate_earclipping(Polygon2dSimple* poly, std::vector<Edge2dSimple>& edge_list);
+	template<class coord_type>
+	void triangulate_earclipping(PolygonSimple<coord_type>* poly, std::vector<EdgeSimple<coord_type>>& edge_list);
+
+	// Ear clipping straight over the points of a simple counter-clockwise polygon, no vertex structures
+	// are built. The ring is kept as next / prev point indices and the ears in a queue, so the ring is
+	// never rescanned, and a candidate ear is only tested against the reflex vertices in the grid cells
+	// under it. Gives n - 3 diagonals like the version above, not necessarily the same ones or in the
+	// same order. Returns false if the polygon ran out of ears (it was not simple), the output is
+	// incomplete then.
+	// This is not O(n log n). It is linear for convex polygons and when the ears stay about as small as
+	// the vertex spacing. On spiky polygons the ears are long and thin, each test walks about sqrt(n)
+	// cells, and the whole runs in about n^1.5. Use triangulate_general when the time has to be bounded.
+	template<class coord_type>
+	bool triangulate_earclipping(const PointView<coord_type, DIM2>& points, std::vector<EdgeSimple<coord_type>>& edge_list);
+
+	// Same triangulation written as triangles, three indices in to points per triangle, counter-clockwise.
+	// If adjacency is given it gets three entries per triangle too: the triangle across the edge
+	// v0 v1, v1 v2 and v2 v0, or NO_ADJACENT_TRIANGLE on the boundary.
+	template<class coord_type>
+	bool triangulate_earclipping(const PointView<coord_type, DIM2>& points, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency = nullptr);
 
 	// Triangulate the given monotone polygon. Result is undefined if the polygon is not monotone
-	void triangulate_monotone(Polygon2d* poly);
+	template<class coord_type>
+	void triangulate_monotone(PolygonDCEL<coord_type, 2>* poly);
+
+	// Same, but the polygon is left untouched and the triangles are written as indices of the points
+	// the polygon was built from (VertexDCEL::index). Same layout as the ear clipping above.
+	template<class coord_type>
+	void triangulate_monotone(PolygonDCEL<coord_type, 2>* poly, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency = nullptr);
+
+	// Both of the above on the index based DCEL
+	template<class coord_type>
+	void triangulate_monotone(ArenaPolygonDCEL<coord_type, 2>* poly);
+
+	template<class coord_type>
+	void triangulate_monotone(ArenaPolygonDCEL<coord_type, 2>* poly, std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency = nullptr);
+
+	// Triangulate the given faces of a larger DCEL in place, e.g. the pieces returned by
+	// partition_monotone. Every face must be y-monotone. No polygon is built per face, the faces are
+	// walked in poly and share one set of working buffers.
+	template<class coord_type>
+	void triangulate_monotone_faces(PolygonDCEL<coord_type, 2>* poly, const std::vector<FaceDCEL<coord_type, 2>*>& faces);
+
+	template<class coord_type>
+	void triangulate_monotone_faces(ArenaPolygonDCEL<coord_type, 2>* poly, const std::vector<uint32_t>& faces);
+
+	// Same written as indices of the points poly was built from, the triangles of each face following
+	// the ones of the face before it. poly is left untouched.
+	template<class coord_type>
+	void triangulate_monotone_faces(PolygonDCEL<coord_type, 2>* poly, const std::vector<FaceDCEL<coord_type, 2>*>& faces,
+		std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency = nullptr);
+
+	template<class coord_type>
+	void triangulate_monotone_faces(ArenaPolygonDCEL<coord_type, 2>* poly, const std::vector<uint32_t>& faces,
+		std::vector<uint32_t>& triangles, std::vector<uint32_t>* adjacency = nullptr);
+
+	// Fill adjacency for the given triangle index buffer, see the layout above
+	void triangle_adjacency(const std::vector<uint32_t>& triangles, std::vector<uint32_t>& adjacency);
 
-	//// Triangulate the general polygon.
-	//// Internally first we partition the polygon in to monotone peices and then call the triangulate_monotone
-	//void triangulate_general(Polygon2d* poly);
+	// Triangulate the general polygon (simple, counter-clockwise) in to the index buffer, same layout as
+	// above. Internally first we partition the polygon in to monotone peices, then the pieces are
+	// triangulated. Both steps use up to thread_count threads (0 uses every hardware thread). Each piece
+	// writes straight in to its own range of triangles, so the output does not depend on the thread count.
+	template<class coord_type>
+	void triangulate_general(const PointView<coord_type, DIM2>& points, std::vector<uint32_t>& triangles, unsigned thread_count = 0);
 }
\ No newline at end of file
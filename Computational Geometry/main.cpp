@@ -4,10 +4,446 @@
 #include "Core/Base/Core.h"
 #include "Core/Base/Vector.h"
 #include "Core/Angle.h"
+#include "Core/Base/SweepStatus.h"
+#include "Core/Base/Parallel.h"
+#include "Core/Predicates.h"
+
+#include <set>
+#include <chrono>
+#include <random>
 
 using namespace jmk;
 using namespace std;
 
+// Milliseconds since start
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Star shaped polygon with random radii, counter-clockwise, about half of its vertices reflex
+static std::vector<Point2d> random_star(size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> radius(20, 100);
+	std::vector<Point2d> points;
+	for (size_t i = 0; i < count; i++)
+	{
+		double angle = 2 * M_PI * i / count, r = radius(generator);
+		points.push_back(Point2d((float)(r * cos(angle)), (float)(r * sin(angle))));
+	}
+	return points;
+}
+
+static void benchmark_earclipping()
+{
+	cout << "\n-----Ear Clipping Benchmark (vertex structures vs point indices)----\n";
+
+	// The version over vertex structures rescans the ring for every ear, it is only run on the
+	// smaller polygons.
+	for (size_t count : { 1000, 4000, 16000, 64000 })
+	{
+		std::vector<Point2d> points = random_star(count, 3);
+
+		std::vector<Edge2dSimple> diagonals;
+		auto start = std::chrono::steady_clock::now();
+		triangulate_earclipping(PointView<float, DIM2>(points), diagonals);
+		cout << count << " vertices, point indices " << elapsed_ms(start) << " ms (" << diagonals.size() << " diagonals)";
+
+		if (count <= 4000)
+		{
+			Polygon2dSimple polygon(points);
+			std::vector<Edge2dSimple> vertex_diagonals;
+			start = std::chrono::steady_clock::now();
+			triangulate_earclipping(&polygon, vertex_diagonals);
+			cout << ", vertex structures " << elapsed_ms(start) << " ms (" << vertex_diagonals.size() << " diagonals)";
+
+			for (auto vertex : polygon.getVertices())
+				delete vertex;
+		}
+		cout << "\n";
+	}
+
+	// The queue version on three shapes, in double: a convex ring, a crown of alternating radii and the
+	// random star. The long thin ears of the spiky ones are what makes them grow faster than n. (In float
+	// the large convex rings have runs of collinear vertices, which are kept as reflex.)
+	for (size_t count : { 4096, 16384, 65536, 262144 })
+	{
+		std::vector<Point2lf> convex, crown, star;
+		for (size_t i = 0; i < count; i++)
+		{
+			double angle = 2 * M_PI * i / count, r = (i % 2) ? 60 : 100;
+			convex.push_back(Point2lf(100 * cos(angle), 100 * sin(angle)));
+			crown.push_back(Point2lf(r * cos(angle), r * sin(angle)));
+		}
+		for (const auto& point : random_star(count, 3))
+			star.push_back(Point2lf(point[X], point[Y]));
+
+		cout << count << " vertices";
+		for (auto shape : { std::make_pair("convex", &convex), std::make_pair("crown", &crown), std::make_pair("star", &star) })
+		{
+			std::vector<uint32_t> triangles;
+			auto start = std::chrono::steady_clock::now();
+			triangulate_earclipping(PointView<double, DIM2>(*shape.second), triangles);
+			cout << ", " << shape.first << " " << elapsed_ms(start) << " ms";
+		}
+
+		std::vector<uint32_t> triangles;
+		auto start = std::chrono::steady_clock::now();
+		triangulate_general(PointView<double, DIM2>(star), triangles, 1);
+		cout << " (star with triangulate_general " << elapsed_ms(start) << " ms)\n";
+	}
+}
+
+// y-monotone polygon whose left and right chains both zig-zag, 2 * teeth + 2 vertices, counter-clockwise.
+// Every chain vertex leaves a reflex vertex on the stack of the monotone triangulation.
+static std::vector<Point2d> zigzag_monotone(size_t teeth)
+{
+	std::vector<Point2d> points;
+	points.push_back(Point2d(0, (float)(2 * teeth + 2)));
+	for (size_t i = 0; i < teeth; i++)
+		points.push_back(Point2d((i % 2) ? -3.0f : -1.0f, (float)(2 * teeth + 1 - 2 * i)));
+	points.push_back(Point2d(0, 0));
+	for (size_t i = teeth; i-- > 0;)
+		points.push_back(Point2d((i % 2) ? 2.0f : 4.0f, (float)(2 * teeth - 2 * i)));
+	return points;
+}
+
+static void benchmark_monotone_triangulation()
+{
+	cout << "\n-----Monotone Triangulation Benchmark (zig-zag chains)----\n";
+
+	for (size_t teeth : { 8000, 32000, 128000, 512000 })
+	{
+		std::vector<Point2d> points = zigzag_monotone(teeth);
+		std::vector<uint32_t> triangles;
+
+		Polygon2d polygon(points);
+		auto start = std::chrono::steady_clock::now();
+		triangulate_monotone(&polygon, triangles);
+		double pointer_ms = elapsed_ms(start);
+
+		ArenaPolygon2d arena_polygon(points);
+		start = std::chrono::steady_clock::now();
+		triangulate_monotone(&arena_polygon, triangles);
+		double arena_ms = elapsed_ms(start);
+
+		cout << points.size() << " vertices, PolygonDCEL " << pointer_ms << " ms, ArenaPolygonDCEL " << arena_ms
+			<< " ms (" << triangles.size() / 3 << " triangles)\n";
+	}
+}
+
+static void benchmark_sweep_status()
+{
+	cout << "\n-----Sweep Status Benchmark (SweepStatus vs std::set)----\n";
+
+	// Keys are pointers compared through what they point to, like the edges of a sweep line.
+	// Every size is timed for building, replacing every key (erase + insert) and predecessor queries.
+	struct KeyLess
+	{
+		bool operator()(const double* a, const double* b) const { return *a < *b; }
+	};
+
+	for (size_t count : { 1000, 10000, 100000, 1000000 })
+	{
+		std::vector<double> keys(2 * count);
+		std::mt19937 generator(9);
+		std::uniform_real_distribution<double> distribution(0, 1);
+		for (auto& key : keys)
+			key = distribution(generator);
+
+		auto time_ns = [count](std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+		};
+
+		{
+			std::set<const double*, KeyLess> status;
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++)
+				status.insert(&keys[i]);
+			double build = time_ns(start);
+
+			start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++)
+			{
+				status.erase(status.find(&keys[i]));
+				status.insert(&keys[count + i]);
+			}
+			double replace = time_ns(start);
+
+			start = std::chrono::steady_clock::now();
+			size_t found = 0;
+			for (size_t i = 0; i < count; i++)
+				found += status.lower_bound(&keys[i]) != status.begin();
+			double predecessor = time_ns(start);
+
+			cout << count << " std::set    build " << build << " ns, erase + insert " << replace << " ns, predecessor " << predecessor << " ns (" << found << ")\n";
+		}
+
+		{
+			SweepStatus<const double*, KeyLess> status;
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++)
+				status.insert(&keys[i]);
+			double build = time_ns(start);
+
+			start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i++)
+			{
+				status.erase(status.find(&keys[i]));
+				status.insert(&keys[count + i]);
+			}
+			double replace = time_ns(start);
+
+			start = std::chrono::steady_clock::now();
+			size_t found = 0;
+			for (size_t i = 0; i < count; i++)
+				found += status.predecessor(&keys[i]) != status.end();
+			double predecessor = time_ns(start);
+
+			cout << count << " SweepStatus build " << build << " ns, erase + insert " << replace << " ns, predecessor " << predecessor << " ns (" << found << ")\n";
+		}
+	}
+}
+
+// Wavy closed outline, counter-clockwise, with many turning points in y
+static std::vector<Point2lf> wavy_outline(size_t count)
+{
+	std::vector<Point2lf> points;
+	for (size_t i = 0; i < count; i++)
+	{
+		double angle = 2 * M_PI * i / count;
+		double r = 60 + 20 * sin(7 * angle) + 10 * sin(31 * angle) + 3 * sin(173 * angle);
+		points.push_back(Point2lf(r * cos(angle), r * sin(angle)));
+	}
+	return points;
+}
+
+static void benchmark_slab_partition()
+{
+	cout << "\n-----Monotone Partition Benchmark (serial sweep vs slabs)----\n";
+	cout << default_thread_count() << " hardware threads\n";
+
+	// The slabs are forced on with a threshold of 0. Until they beat the serial sweep on some machine
+	// they stay off by default, see MONOTONE_PARALLEL_THRESHOLD.
+	for (size_t count : { 1 << 18, 1 << 20 })
+	{
+		std::vector<Point2lf> points = wavy_outline(count);
+
+		ArenaPolygon2lf serial(points);
+		auto start = std::chrono::steady_clock::now();
+		partition_monotone(&serial, 1);
+		cout << count << " vertices, serial " << elapsed_ms(start) << " ms";
+
+		for (unsigned threads : { 2, 4, 8, 16, 32 })
+		{
+			ArenaPolygon2lf polygon(points);
+			start = std::chrono::steady_clock::now();
+			partition_monotone(&polygon, threads, 0);
+			cout << ", " << threads << " slabs " << elapsed_ms(start) << " ms";
+		}
+		cout << "\n";
+	}
+}
+
+static void benchmark_orient2d()
+{
+	cout << "\n-----orient2d Benchmark (filtered predicate vs areaTriangle2d + TOLERANCE)----\n";
+
+	// Random triples, so the filter almost always decides the sign in double and the exact stages
+	// are not reached. The nearly collinear triples show where the two give different signs.
+	const size_t count = 3000000;
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<float> distribution(-100, 100);
+	std::vector<Point2d> points;
+	for (size_t i = 0; i < 3 * count; i++)
+		points.push_back(Point2d(distribution(generator), distribution(generator)));
+
+	auto old_sign = [](const Point2d& a, const Point2d& b, const Point2d& c) {
+		auto area = areaTriangle2d(a, b, c);
+		if (area > 0 && area < TOLERANCE)
+			area = 0;
+		if (area < 0 && area > -TOLERANCE)
+			area = 0;
+		return (area > 0) - (area < 0);
+	};
+	auto new_sign = [](const Point2d& a, const Point2d& b, const Point2d& c) {
+		auto area = orient2d(a, b, c);
+		return (area > 0) - (area < 0);
+	};
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		long long sum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; i++)
+			sum += pass ? new_sign(points[3 * i], points[3 * i + 1], points[3 * i + 2]) : old_sign(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+		double ns = elapsed_ms(start) * 1e6 / count;
+		cout << (pass ? "orient2d " : "areaTriangle2d + TOLERANCE ") << ns << " ns per triple (" << sum << ")\n";
+	}
+
+	// c on the line through a and b up to float rounding
+	size_t differ = 0;
+	for (size_t i = 0; i < 100000; i++)
+	{
+		const Point2d& a = points[2 * i];
+		const Point2d& b = points[2 * i + 1];
+		float t = (float)i / 100000;
+		Point2d c(a[X] + t * (b[X] - a[X]), a[Y] + t * (b[Y] - a[Y]));
+		differ += old_sign(a, b, c) != new_sign(a, b, c);
+	}
+	cout << "nearly collinear: " << differ << " of 100000 signs differ\n";
+}
+
+static void benchmark_float_vs_double()
+{
+	cout << "\n-----triangulate_general Benchmark (float vs double)----\n";
+
+	// The same vertices in both precisions, the float ones are rounded from double
+	for (size_t count : { 4096, 16384, 65536, 262144 })
+	{
+		std::vector<Point2lf> star, wavy = wavy_outline(count);
+		for (const auto& point : random_star(count, 11))
+			star.push_back(Point2lf(point[X], point[Y]));
+
+		cout << count << " vertices";
+		for (auto shape : { std::make_pair("star", &star), std::make_pair("wavy", &wavy) })
+		{
+			std::vector<Point2d> rounded;
+			for (const auto& point : *shape.second)
+				rounded.push_back(Point2d((float)point[X], (float)point[Y]));
+
+			std::vector<uint32_t> float_triangles, double_triangles;
+			auto start = std::chrono::steady_clock::now();
+			triangulate_general(PointView<float, DIM2>(rounded), float_triangles, 1);
+			double float_ms = elapsed_ms(start);
+
+			start = std::chrono::steady_clock::now();
+			triangulate_general(PointView<double, DIM2>(*shape.second), double_triangles, 1);
+			double double_ms = elapsed_ms(start);
+
+			cout << ", " << shape.first << " float " << float_ms << " ms, double " << double_ms << " ms ("
+				<< float_triangles.size() / 3 << " / " << double_triangles.size() / 3 << " triangles)";
+		}
+		cout << "\n";
+	}
+}
+
+// Build, partition, walk and free one DCEL backend, printing its bytes and times
+template<class DCEL>
+static void benchmark_dcel_backend(const char* name, const std::vector<Point2d>& points)
+{
+	auto start = std::chrono::steady_clock::now();
+	DCEL* polygon = new DCEL(PointView<float, DIM2>(points));
+	double build_ms = elapsed_ms(start);
+
+	partition_monotone(polygon, 1);
+	size_t bytes = polygon->memoryUsage();
+
+	// Every boundary and every star is walked a few times, the steps are the edges visited
+	const int passes = 5;
+	size_t steps = 0;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++)
+		for (auto face : polygon->faceRange())
+			if (polygon->isBounded(face))
+				for (auto edge : polygon->faceBoundary(face))
+					steps += polygon->index(polygon->origin(edge)) != DCEL_NULL;
+	double boundary_rate = steps / elapsed_ms(start) / 1000;
+
+	steps = 0;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++)
+		for (auto vertex : polygon->vertexRange())
+			for (auto edge : polygon->vertexStar(vertex))
+				steps += polygon->index(polygon->destination(edge)) != DCEL_NULL;
+	double star_rate = steps / elapsed_ms(start) / 1000;
+
+	start = std::chrono::steady_clock::now();
+	polygon->clear();
+	delete polygon;
+	double free_ms = elapsed_ms(start);
+
+	cout << ", " << name << " " << bytes / 1024 << " KiB, build " << build_ms << " ms, free " << free_ms
+		<< " ms, faceBoundary " << boundary_rate << " M steps/s, vertexStar " << star_rate << " M steps/s";
+}
+
+static void benchmark_dcel_backends()
+{
+	cout << "\n-----DCEL Benchmark (PolygonDCEL vs ArenaPolygonDCEL)----\n";
+
+	// The polygons are split in to monotone pieces first, so there are faces and stars to walk.
+	// PolygonDCEL's bytes are an estimate, see memoryUsage.
+	for (size_t count : { 16384, 131072, 1048576 })
+	{
+		std::vector<Point2d> points = random_star(count, 13);
+		cout << count << " vertices";
+		benchmark_dcel_backend<Polygon2d>("PolygonDCEL", points);
+		cout << "\n" << count << " vertices";
+		benchmark_dcel_backend<ArenaPolygon2d>("ArenaPolygonDCEL", points);
+		cout << "\n";
+	}
+}
+
+// Partition the polygon, join every other diagonal back and hash the faces that are left
+template<class DCEL>
+static uint64_t partition_join_hash(const std::vector<Point2d>& points)
+{
+	DCEL polygon{ PointView<float, DIM2>(points) };
+	partition_monotone(&polygon, 1);
+
+	std::vector<typename DCEL::EdgeHandle> diagonals;
+	bool take = false;
+	for (auto edge : polygon.edgeRange())
+	{
+		auto twin = polygon.twin(edge);
+		if (polygon.isBounded(polygon.incidentFace(edge)) && polygon.isBounded(polygon.incidentFace(twin))
+			&& polygon.index(polygon.origin(edge)) < polygon.index(polygon.destination(edge)) && (take = !take))
+			diagonals.push_back(edge);
+	}
+	polygon.joinMany(diagonals);
+
+	uint64_t hash = 1469598103934665603ull;
+	for (auto face : polygon.faceRange())
+		if (polygon.isBounded(face))
+			for (auto edge : polygon.faceBoundary(face))
+				hash = (hash ^ polygon.index(polygon.origin(edge))) * 1099511628211ull;
+	polygon.clear();
+	return hash;
+}
+
+static void check_parallel_polygons()
+{
+	cout << "\n-----Separate polygons on separate threads (serial vs parallel_for)----\n";
+
+	// Every polygon is built, partitioned, joined and triangulated on its own, with both DCELs. Run on
+	// several threads the results must be the same as serially, see the thread safety notes in
+	// PolygonDCEL.h and ArenaPolygonDCEL.h.
+	const size_t count = 2000;
+	auto work = [](size_t i) {
+		std::vector<Point2d> points = random_star(20 + 2 * (i % 100), (unsigned)i);
+		uint64_t hash = partition_join_hash<Polygon2d>(points) * 31 + partition_join_hash<ArenaPolygon2d>(points);
+
+		std::vector<uint32_t> triangles;
+		triangulate_general(PointView<float, DIM2>(points), triangles, 1);
+		for (auto index : triangles)
+			hash = (hash ^ index) * 1099511628211ull;
+		return hash;
+	};
+
+	std::vector<uint64_t> serial(count), parallel(count);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++)
+		serial[i] = work(i);
+	double serial_ms = elapsed_ms(start);
+
+	start = std::chrono::steady_clock::now();
+	parallel_for(count, [&](size_t i) { parallel[i] = work(i); }, 8);
+	double parallel_ms = elapsed_ms(start);
+
+	cout << count << " polygons, serial " << serial_ms << " ms, 8 threads " << parallel_ms << " ms, results "
+		<< (serial == parallel ? "the same" : "DIFFERENT") << "\n";
+}
 
 int main()
 {
@@ -567,6 +1003,14 @@ int main()
 		delete mono_poly;
 	}
 
+	benchmark_earclipping();
+	benchmark_monotone_triangulation();
+	benchmark_sweep_status();
+	benchmark_orient2d();
+	benchmark_slab_partition();
+	benchmark_float_vs_double();
+	benchmark_dcel_backends();
+	check_parallel_polygons();
 
 	return 0;
 }